@@ -58,6 +58,8 @@ int RAI_ExportFunc(const char *func_name, void **targetFuncPtr) {
         *targetFuncPtr = BGWorker_GetThreadsCount;
     } else if (strcmp("GetBackendMemoryLimit", func_name) == 0) {
         *targetFuncPtr = Config_GetBackendMemoryLimit;
+    } else if (strcmp("GetModelSessionPoolSize", func_name) == 0) {
+        *targetFuncPtr = Config_GetModelSessionPoolSize;
 
         // Export RedisAI low level API functions.
     } else if (strcmp("RedisAI_InitError", func_name) == 0) {
@@ -74,6 +76,10 @@ int RAI_ExportFunc(const char *func_name, void **targetFuncPtr) {
         *targetFuncPtr = RAI_TensorGetShallowCopy;
     } else if (strcmp("RedisAI_TensorFree", func_name) == 0) {
         *targetFuncPtr = RAI_TensorFree;
+    } else if (strcmp("RedisAI_TensorGetFromKeyspace", func_name) == 0) {
+        *targetFuncPtr = RAI_TensorGetFromKeyspace;
+    } else if (strcmp("RedisAI_TensorSetInKeyspace", func_name) == 0) {
+        *targetFuncPtr = RAI_TensorSetInKeyspace;
     } else if (strcmp("RedisAI_GetModelFromKeyspace", func_name) == 0) {
         *targetFuncPtr = RAI_GetModelFromKeyspace;
     } else if (strcmp("RedisAI_ModelRunCtxCreate", func_name) == 0) {
@@ -248,6 +254,20 @@ int RAI_LoadBackend_TFLite(RedisModuleCtx *ctx, const char *path) {
         goto error;
     }
 
+    backend.get_shape_cache_hits =
+        (unsigned long long (*)(void))(unsigned long)dlsym(handle, "RAI_GetShapeCacheHitsTFLite");
+    if (!_ValidateFuncExists(ctx, backend.get_shape_cache_hits, "RAI_GetShapeCacheHitsTFLite",
+                             "TFLite", path)) {
+        goto error;
+    }
+
+    backend.get_shape_cache_misses = (unsigned long long (*)(void))(unsigned long)dlsym(
+        handle, "RAI_GetShapeCacheMissesTFLite");
+    if (!_ValidateFuncExists(ctx, backend.get_shape_cache_misses, "RAI_GetShapeCacheMissesTFLite",
+                             "TFLite", path)) {
+        goto error;
+    }
+
     RAI_backends.tflite = backend;
     RedisModule_Log(ctx, "notice", "TFLITE backend loaded from %s", path);
     return REDISMODULE_OK;
@@ -334,6 +354,20 @@ int RAI_LoadBackend_Torch(RedisModuleCtx *ctx, const char *path) {
         goto error;
     }
 
+    backend.get_outputs_copied =
+        (unsigned long long (*)(void))(unsigned long)dlsym(handle, "RAI_GetOutputsCopiedTorch");
+    if (!_ValidateFuncExists(ctx, backend.get_outputs_copied, "RAI_GetOutputsCopiedTorch",
+                             "TORCH", path)) {
+        goto error;
+    }
+
+    backend.get_outputs_copies_saved = (unsigned long long (*)(void))(unsigned long)dlsym(
+        handle, "RAI_GetOutputsCopiesSavedTorch");
+    if (!_ValidateFuncExists(ctx, backend.get_outputs_copies_saved,
+                             "RAI_GetOutputsCopiesSavedTorch", "TORCH", path)) {
+        goto error;
+    }
+
     RAI_backends.torch = backend;
     RedisModule_Log(ctx, "notice", "TORCH backend loaded from %s", path);
     return REDISMODULE_OK;
@@ -487,3 +521,18 @@ int RAI_LoadDefaultBackend(RedisModuleCtx *ctx, int backend) {
 
     return REDISMODULE_ERR;
 }
+
+bool RAI_IsBackendLoaded(RAI_Backend backend) {
+    switch (backend) {
+    case RAI_BACKEND_TENSORFLOW:
+        return RAI_backends.tf.model_run != NULL;
+    case RAI_BACKEND_TFLITE:
+        return RAI_backends.tflite.model_run != NULL;
+    case RAI_BACKEND_TORCH:
+        return RAI_backends.torch.model_run != NULL;
+    case RAI_BACKEND_ONNXRUNTIME:
+        return RAI_backends.onnx.model_run != NULL;
+    }
+
+    return false;
+}
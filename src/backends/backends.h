@@ -89,6 +89,20 @@ typedef struct RAI_LoadedBackend {
     // Returns the number of times that Redis accessed backend allocator.
     unsigned long long (*get_memory_access_num)(void);
 
+    // Returns the number of model runs that found an execution context (e.g., a TFLite
+    // interpreter) already prepared for their input shapes.
+    unsigned long long (*get_shape_cache_hits)(void);
+
+    // Returns the number of model runs that had to prepare an execution context for their
+    // input shapes.
+    unsigned long long (*get_shape_cache_misses)(void);
+
+    // Returns the number of output tensors that had to be copied to be handed back.
+    unsigned long long (*get_outputs_copied)(void);
+
+    // Returns the number of output tensors that were copied once rather than twice.
+    unsigned long long (*get_outputs_copies_saved)(void);
+
     // A callback for to use whenever a new device is introduced.
     int (*add_new_device_cb)(const char *);
 
@@ -112,6 +126,11 @@ int RAI_LoadBackend(RedisModuleCtx *ctx, int backend, const char *path);
 
 int RAI_LoadDefaultBackend(RedisModuleCtx *ctx, int backend);
 
+/**
+ * @brief Returns true if the given backend is loaded.
+ */
+bool RAI_IsBackendLoaded(RAI_Backend backend);
+
 /**
  * @brief Returns the backend name as string.
  */
@@ -45,7 +45,7 @@ BACKENDS_API long long (*RedisAI_GetNumThreadsPerQueue)(void);
 /**
  * @return The maximum number of milliseconds that a model run session should run
  * before it is terminated forcefully (load time config).
- * Currently supported only for onnxruntime backend.
+ * Currently supported only for onnxruntime and tensorflow backends.
  */
 BACKENDS_API long long (*RedisAI_GetModelExecutionTimeout)(void);
 
@@ -57,6 +57,13 @@ BACKENDS_API long long (*RedisAI_GetModelExecutionTimeout)(void);
  */
 BACKENDS_API long long (*RedisAI_GetMemoryLimit)(void);
 
+/**
+ * @return The maximum number of sessions (interpreters) that a backend may create for
+ * a single model, to allow concurrent executions of this model (load time config).
+ * Currently supported only for tflite backend.
+ */
+BACKENDS_API long long (*RedisAI_GetModelSessionPoolSize)(void);
+
 /**
  * The following functions are part of RedisAI low level API (the full low level
  * API is defined in redisai.h). For every function below named "RedisAI_X", its
@@ -71,6 +78,11 @@ BACKENDS_API RAI_Tensor *(*RedisAI_TensorCreateFromDLTensor)(DLManagedTensor *dl
 BACKENDS_API DLTensor *(*RedisAI_TensorGetDLTensor)(RAI_Tensor *tensor);
 BACKENDS_API RAI_Tensor *(*RedisAI_TensorGetShallowCopy)(RAI_Tensor *t);
 BACKENDS_API void (*RedisAI_TensorFree)(RAI_Tensor *tensor);
+BACKENDS_API int (*RedisAI_TensorGetFromKeyspace)(RedisModuleCtx *ctx, RedisModuleString *keyName,
+                                                  RedisModuleKey **key, RAI_Tensor **tensor,
+                                                  int mode, RAI_Error *err);
+BACKENDS_API int (*RedisAI_TensorSetInKeyspace)(RedisModuleCtx *ctx, RedisModuleString *keyName,
+                                                RAI_Tensor *t, RAI_Error *err);
 
 BACKENDS_API RAI_ModelRunCtx *(*RedisAI_ModelRunCtxCreate)(RAI_Model *model);
 BACKENDS_API int (*RedisAI_GetModelFromKeyspace)(RedisModuleCtx *ctx, RedisModuleString *keyName,
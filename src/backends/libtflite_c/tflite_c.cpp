@@ -6,6 +6,10 @@
 
 #include <sstream>
 #include <iostream>
+#include <mutex>
+#include <atomic>
+#include <list>
+#include <condition_variable>
 #include "tflite_c.h"
 #include "redismodule.h"
 #include "tensorflow/lite/model.h"
@@ -78,61 +82,54 @@ size_t dltensorBytes(DLManagedTensor *t) {
     return bytes;
 }
 
-void copyToTfLiteTensor(std::shared_ptr<tflite::Interpreter> interpreter, int tflite_input,
-                        DLManagedTensor *input) {
-    TfLiteTensor *tensor = interpreter->tensor(tflite_input);
-    size_t nbytes = dltensorBytes(input);
+// Returns the beginning of the tensor data (the tensor may be a view into a larger blob,
+// which starts at the byte offset).
+const char *dltensorData(DLManagedTensor *t) {
+    return static_cast<const char *>(t->dl_tensor.data) + t->dl_tensor.byte_offset;
+}
+
+void checkInputType(const TfLiteTensor *tensor, DLManagedTensor *input) {
     DLDataType dltensor_type = input->dl_tensor.dtype;
-    const char *type_mismatch_msg = "Input tensor type doesn't match the type expected"
-                                    " by the model definition";
+    bool match = false;
 
     switch (tensor->type) {
     case kTfLiteUInt8:
-        if (dltensor_type.code != kDLUInt || dltensor_type.bits != 8) {
-            throw std::logic_error(type_mismatch_msg);
-        }
-        memcpy(interpreter->typed_tensor<uint8_t>(tflite_input), input->dl_tensor.data, nbytes);
+        match = dltensor_type.code == kDLUInt && dltensor_type.bits == 8;
         break;
     case kTfLiteInt64:
-        if (dltensor_type.code != kDLInt || dltensor_type.bits != 64) {
-            throw std::logic_error(type_mismatch_msg);
-        }
-        memcpy(interpreter->typed_tensor<int64_t>(tflite_input), input->dl_tensor.data, nbytes);
+        match = dltensor_type.code == kDLInt && dltensor_type.bits == 64;
         break;
     case kTfLiteInt32:
-        if (dltensor_type.code != kDLInt || dltensor_type.bits != 32) {
-            throw std::logic_error(type_mismatch_msg);
-        }
-        memcpy(interpreter->typed_tensor<int32_t>(tflite_input), input->dl_tensor.data, nbytes);
+        match = dltensor_type.code == kDLInt && dltensor_type.bits == 32;
         break;
     case kTfLiteInt16:
-        if (dltensor_type.code != kDLInt || dltensor_type.bits != 16) {
-            throw std::logic_error(type_mismatch_msg);
-        }
-        memcpy(interpreter->typed_tensor<int16_t>(tflite_input), input->dl_tensor.data, nbytes);
+        match = dltensor_type.code == kDLInt && dltensor_type.bits == 16;
         break;
     case kTfLiteInt8:
-        if (dltensor_type.code != kDLInt || dltensor_type.bits != 8) {
-            throw std::logic_error(type_mismatch_msg);
-        }
-        memcpy(interpreter->typed_tensor<int8_t>(tflite_input), input->dl_tensor.data, nbytes);
+        match = dltensor_type.code == kDLInt && dltensor_type.bits == 8;
         break;
     case kTfLiteFloat32:
-        if (dltensor_type.code != kDLFloat || dltensor_type.bits != 32) {
-            throw std::logic_error(type_mismatch_msg);
-        }
-        memcpy(interpreter->typed_tensor<float>(tflite_input), input->dl_tensor.data, nbytes);
+        match = dltensor_type.code == kDLFloat && dltensor_type.bits == 32;
         break;
     case kTfLiteBool:
-        if (dltensor_type.code != kDLBool || dltensor_type.bits != 8) {
-            throw std::logic_error(type_mismatch_msg);
-        }
-        memcpy(interpreter->typed_tensor<bool>(tflite_input), input->dl_tensor.data, nbytes);
+        match = dltensor_type.code == kDLBool && dltensor_type.bits == 8;
+        break;
     case kTfLiteFloat16:
         throw std::logic_error("Float16 not currently supported as input tensor data type");
     default:
         throw std::logic_error("Unsupported input data type");
     }
+    if (!match) {
+        throw std::logic_error("Input tensor type doesn't match the type expected"
+                               " by the model definition");
+    }
+}
+
+void copyToTfLiteTensor(std::shared_ptr<tflite::Interpreter> interpreter, int tflite_input,
+                        DLManagedTensor *input) {
+    TfLiteTensor *tensor = interpreter->tensor(tflite_input);
+    checkInputType(tensor, input);
+    memcpy(tensor->data.raw, dltensorData(input), dltensorBytes(input));
 }
 
 void deleter(DLManagedTensor *arg) {
@@ -153,7 +150,25 @@ DLManagedTensor *toManagedDLPack(std::shared_ptr<tflite::Interpreter> interprete
     int64_t device_id = 0;
     DLDevice device = getDLDevice(tensor, device_id);
 
-    DLTensor dl_tensor = (DLTensor){.data = new uint8_t[tensor->bytes],
+    switch (tensor->type) {
+    case kTfLiteUInt8:
+    case kTfLiteInt64:
+    case kTfLiteInt32:
+    case kTfLiteInt16:
+    case kTfLiteInt8:
+    case kTfLiteFloat32:
+    case kTfLiteBool:
+        break;
+    case kTfLiteFloat16:
+        throw std::logic_error("Float16 not currently supported as output tensor data type");
+    default:
+        throw std::logic_error("Unsupported output data type");
+    }
+
+    uint8_t *data = new uint8_t[tensor->bytes];
+    memcpy(data, tensor->data.raw, tensor->bytes);
+
+    DLTensor dl_tensor = (DLTensor){.data = data,
                                     .device = device,
                                     .ndim = output_dims->size,
                                     .dtype = dtype,
@@ -170,36 +185,6 @@ DLManagedTensor *toManagedDLPack(std::shared_ptr<tflite::Interpreter> interprete
         dl_tensor.strides[i] *= dl_tensor.strides[i + 1] * dl_tensor.shape[i + 1];
     }
 
-    auto output_size = output_dims->data[output_dims->size - 1];
-
-    switch (tensor->type) {
-    case kTfLiteUInt8:
-        memcpy(dl_tensor.data, interpreter->typed_tensor<uint8_t>(tflite_output), tensor->bytes);
-        break;
-    case kTfLiteInt64:
-        memcpy(dl_tensor.data, interpreter->typed_tensor<int64_t>(tflite_output), tensor->bytes);
-        break;
-    case kTfLiteInt32:
-        memcpy(dl_tensor.data, interpreter->typed_tensor<int32_t>(tflite_output), tensor->bytes);
-        break;
-    case kTfLiteInt16:
-        memcpy(dl_tensor.data, interpreter->typed_tensor<int16_t>(tflite_output), tensor->bytes);
-        break;
-    case kTfLiteInt8:
-        memcpy(dl_tensor.data, interpreter->typed_tensor<int8_t>(tflite_output), tensor->bytes);
-        break;
-    case kTfLiteFloat32:
-        memcpy(dl_tensor.data, interpreter->typed_tensor<float>(tflite_output), tensor->bytes);
-        break;
-    case kTfLiteBool:
-        memcpy(dl_tensor.data, interpreter->typed_tensor<bool>(tflite_output), tensor->bytes);
-        break;
-    case kTfLiteFloat16:
-        throw std::logic_error("Float16 not currently supported as output tensor data type");
-    default:
-        throw std::logic_error("Unsupported output data type");
-    }
-
     // We use alloc here to allow deallocation from the module
     DLManagedTensor *output = (DLManagedTensor *)RedisModule_Alloc(sizeof(DLManagedTensor));
     output->dl_tensor = dl_tensor;
@@ -217,62 +202,188 @@ static inline void _setError(const char *what, char **error) {
     *error = RedisModule_Strdup(what);
 }
 
+// The options for creating the interpreters of a model.
+struct InterpreterOptions {
+    // Number of threads that an interpreter may use (the TFLite default if not positive).
+    int num_threads;
+};
+
+// Runs that found an idle interpreter planned for their input shapes (hits), and runs that
+// had to create an interpreter or re-plan one for new shapes (misses), over all models.
+static std::atomic<unsigned long long> shape_cache_hits(0);
+static std::atomic<unsigned long long> shape_cache_misses(0);
+
 struct ModelContext {
     std::shared_ptr<tflite::FlatBufferModel> model;
+    // The first interpreter created for the model, used for fetching its metadata.
     std::shared_ptr<tflite::Interpreter> interpreter;
-    std::string buffer;
     DLDeviceType device;
     int64_t device_id;
+    InterpreterOptions options;
+
+    // An interpreter cannot serve more than one run at a time, while the (read-only)
+    // model can be shared. Every run takes an idle interpreter from the pool, preferably
+    // one whose tensors are already allocated for the run input shapes, so that runs with
+    // different input shapes (e.g. varying batch sizes) do not have to re-plan a shared
+    // interpreter. New interpreters are created on demand up to pool_size of them, and
+    // then the least recently used idle one is re-planned. The idle list is kept in LRU
+    // order (the least recently used interpreter is at the front).
+    std::mutex pool_mutex;
+    std::condition_variable pool_cond;
+    std::list<std::shared_ptr<tflite::Interpreter>> idle_interpreters;
+    size_t interpreters_count;
+    size_t pool_size;
 };
 
-} // namespace
-
-extern "C" void tfliteBasicTest() {}
-
-extern "C" void *tfliteLoadModel(const char *graph, size_t graphlen, DLDeviceType device,
-                                 int64_t device_id, char **error) {
-    std::string graphstr(graph, graphlen);
-
-    std::shared_ptr<tflite::FlatBufferModel> model;
-    std::unique_ptr<tflite::Interpreter> interpreter_;
-    model = tflite::FlatBufferModel::BuildFromBuffer(graphstr.c_str(), graphlen);
-    if (!model) {
-        _setError("Failed to load model from buffer", error);
-        return NULL;
-    }
-
+static std::shared_ptr<tflite::Interpreter> createInterpreter(tflite::FlatBufferModel *model,
+                                                              DLDeviceType device,
+                                                              const InterpreterOptions &options,
+                                                              char **error) {
     tflite::ops::builtin::BuiltinOpResolver resolver;
+    std::unique_ptr<tflite::Interpreter> interpreter;
 
-    tflite::InterpreterBuilder(*model, resolver)(&interpreter_);
-    if (!interpreter_) {
+    tflite::InterpreterBuilder(*model, resolver)(&interpreter);
+    if (!interpreter) {
         _setError("Failed to construct interpreter", error);
-        return NULL;
+        return nullptr;
+    }
+
+    if (options.num_threads > 0) {
+        interpreter->SetNumThreads(options.num_threads);
     }
 
 #if RAI_TFLITE_USE_CUDA
     if (device == DLDeviceType::kDLCUDA) {
         tflite::Interpreter::TfLiteDelegatePtr delegate =
-            tflite::evaluation::CreateGPUDelegate(model.get());
-        if (interpreter_->ModifyGraphWithDelegate(std::move(delegate)) != kTfLiteOk) {
+            tflite::evaluation::CreateGPUDelegate(model);
+        if (interpreter->ModifyGraphWithDelegate(std::move(delegate)) != kTfLiteOk) {
             _setError("Failed to set GPU delegate", error);
-            return NULL;
+            return nullptr;
         }
     }
 #endif
 
-    if (interpreter_->AllocateTensors() != kTfLiteOk) {
+    if (interpreter->AllocateTensors() != kTfLiteOk) {
         _setError("Failed to allocate tensors", error);
+        return nullptr;
+    }
+
+    return std::shared_ptr<tflite::Interpreter>(std::move(interpreter));
+}
+
+// Returns true if the interpreter tensors are allocated for the given inputs' shapes.
+static bool interpreterMatchesInputs(const tflite::Interpreter *interpreter, long n_inputs,
+                                     DLManagedTensor **inputs) {
+    const std::vector<int> &tflite_inputs = interpreter->inputs();
+    if (n_inputs != tflite_inputs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < tflite_inputs.size(); i++) {
+        const TfLiteIntArray *dims = interpreter->tensor(tflite_inputs[i])->dims;
+        const DLTensor *dl_tensor = &inputs[i]->dl_tensor;
+        if (dims->size != dl_tensor->ndim) {
+            return false;
+        }
+        for (int j = 0; j < dims->size; j++) {
+            if (dims->data[j] != dl_tensor->shape[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Take an idle interpreter from the pool, preferably the most recently used one that is
+// planned for the inputs' shapes. Otherwise, create a new one if the pool is not full, or
+// take the least recently used idle interpreter (to be re-planned by the caller). If every
+// interpreter is busy and the pool is full, wait until another run returns its interpreter.
+static std::shared_ptr<tflite::Interpreter> acquireInterpreter(ModelContext *ctx, long n_inputs,
+                                                               DLManagedTensor **inputs,
+                                                               char **error) {
+    std::unique_lock<std::mutex> lock(ctx->pool_mutex);
+    while (true) {
+        for (auto it = ctx->idle_interpreters.rbegin(); it != ctx->idle_interpreters.rend();
+             ++it) {
+            if (interpreterMatchesInputs(it->get(), n_inputs, inputs)) {
+                auto interpreter = std::move(*it);
+                ctx->idle_interpreters.erase(std::next(it).base());
+                shape_cache_hits++;
+                return interpreter;
+            }
+        }
+        if (ctx->interpreters_count < ctx->pool_size) {
+            // Reserve a place in the pool, and create the interpreter without holding the lock.
+            ctx->interpreters_count++;
+            lock.unlock();
+            shape_cache_misses++;
+            auto interpreter =
+                createInterpreter(ctx->model.get(), ctx->device, ctx->options, error);
+            if (!interpreter) {
+                lock.lock();
+                ctx->interpreters_count--;
+            }
+            return interpreter;
+        }
+        if (!ctx->idle_interpreters.empty()) {
+            auto interpreter = std::move(ctx->idle_interpreters.front());
+            ctx->idle_interpreters.pop_front();
+            shape_cache_misses++;
+            return interpreter;
+        }
+        ctx->pool_cond.wait(lock);
+    }
+}
+
+static void releaseInterpreter(ModelContext *ctx, std::shared_ptr<tflite::Interpreter> interpreter) {
+    {
+        std::lock_guard<std::mutex> lock(ctx->pool_mutex);
+        ctx->idle_interpreters.push_back(std::move(interpreter));
+    }
+    ctx->pool_cond.notify_one();
+}
+
+// Returns the interpreter to the pool when the run is over (on every return path).
+struct InterpreterGuard {
+    ModelContext *ctx;
+    std::shared_ptr<tflite::Interpreter> interpreter;
+    ~InterpreterGuard() {
+        if (interpreter) {
+            releaseInterpreter(ctx, std::move(interpreter));
+        }
+    }
+};
+
+} // namespace
+
+extern "C" void tfliteBasicTest() {}
+
+extern "C" void *tfliteLoadModel(const char *graph, size_t graphlen, DLDeviceType device,
+                                 int64_t device_id, size_t pool_size, int num_threads,
+                                 char **error) {
+    // The model is built on top of the caller's buffer (without copying it).
+    std::shared_ptr<tflite::FlatBufferModel> model;
+    model = tflite::FlatBufferModel::BuildFromBuffer(graph, graphlen);
+    if (!model) {
+        _setError("Failed to load model from buffer", error);
         return NULL;
     }
 
-    std::shared_ptr<tflite::Interpreter> interpreter = std::move(interpreter_);
+    InterpreterOptions options = {num_threads};
+    std::shared_ptr<tflite::Interpreter> interpreter =
+        createInterpreter(model.get(), device, options, error);
+    if (!interpreter) {
+        return NULL;
+    }
 
     ModelContext *ctx = new ModelContext();
     ctx->device = device;
     ctx->device_id = device_id;
+    ctx->options = options;
     ctx->model = std::move(model);
-    ctx->interpreter = std::move(interpreter);
-    ctx->buffer = std::move(graphstr);
+    ctx->interpreter = interpreter;
+    ctx->idle_interpreters.push_back(std::move(interpreter));
+    ctx->interpreters_count = 1;
+    ctx->pool_size = pool_size > 0 ? pool_size : 1;
 
     return ctx;
 }
@@ -327,8 +438,11 @@ extern "C" void tfliteRunModel(void *ctx, long n_inputs, DLManagedTensor **input
                                DLManagedTensor **outputs, char **error) {
     ModelContext *ctx_ = (ModelContext *)ctx;
 
-    auto interpreter = ctx_->interpreter;
-    auto model = ctx_->model;
+    InterpreterGuard guard{ctx_, acquireInterpreter(ctx_, n_inputs, inputs, error)};
+    if (!guard.interpreter) {
+        return;
+    }
+    auto interpreter = guard.interpreter;
 
     const std::vector<int> tflite_inputs = interpreter->inputs();
     const std::vector<int> tflite_outputs = interpreter->outputs();
@@ -345,10 +459,9 @@ extern "C" void tfliteRunModel(void *ctx, long n_inputs, DLManagedTensor **input
 
     // NOTE: TFLITE requires all tensors in the graph to be explicitly
     // preallocated before input tensors are memcopied. These are cached
-    // in the session, so we need to check if for instance the batch size
-    // has changed or the shape has changed in general compared to the
-    // previous run and in that case we resize input tensors and call
-    // the AllocateTensor function manually.
+    // in the interpreter, so if the pool had no interpreter planned for
+    // these input shapes (e.g. a new batch size), we resize input tensors
+    // and call the AllocateTensor function manually.
     bool need_reallocation = false;
     std::vector<int> dims;
     for (size_t i = 0; i < tflite_inputs.size(); i++) {
@@ -399,6 +512,10 @@ extern "C" void tfliteRunModel(void *ctx, long n_inputs, DLManagedTensor **input
     }
 }
 
+extern "C" unsigned long long tfliteShapeCacheHits() { return shape_cache_hits; }
+
+extern "C" unsigned long long tfliteShapeCacheMisses() { return shape_cache_misses; }
+
 extern "C" void tfliteSerializeModel(void *ctx, char **buffer, size_t *len, char **error) {
     // NO OP
 }
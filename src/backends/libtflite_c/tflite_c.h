@@ -14,8 +14,9 @@ extern "C" {
 
 // void tfliteBasicTest();
 
+// The model is not copied, so the graph buffer must outlive the returned context.
 void *tfliteLoadModel(const char *model, size_t modellen, DLDeviceType device, int64_t device_id,
-                      char **error);
+                      size_t pool_size, int num_threads, char **error);
 
 void tfliteRunModel(void *ctx, long nInputs, DLManagedTensor **inputs, long nOutputs,
                     DLManagedTensor **outputs, char **error);
@@ -32,6 +33,10 @@ size_t tfliteModelNumOutputs(void *ctx, char **error);
 
 const char *tfliteModelOutputNameAtIndex(void *modelCtx, size_t index, char **error);
 
+unsigned long long tfliteShapeCacheHits(void);
+
+unsigned long long tfliteShapeCacheMisses(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,10 +13,15 @@
 #include "torch/csrc/jit/serialization/import.h"
 #include "torch/csrc/jit/api/compilation_unit.h"
 
+#include <atomic>
 #include <iostream>
 #include <sstream>
+#include <unordered_map>
 
 #include "torch_extensions/torch_redis.h"
+
+static TorchScriptFunctionArgumentType getArgumentType(const c10::Argument &arg);
+
 namespace {
 
 static DLDataType getDLDataType(const at::Tensor &t) {
@@ -166,7 +171,8 @@ torch::Tensor fromDLPack(const DLTensor *src) {
     at::DeviceType device_type = getATenDeviceType(src->device.device_type);
     at::ScalarType stype = toScalarType(src->dtype);
     torch::Device device(device_type, src->device.device_id);
-    return torch::from_blob(src->data, at::IntArrayRef(src->shape, src->ndim),
+    return torch::from_blob(static_cast<char *>(src->data) + src->byte_offset,
+                            at::IntArrayRef(src->shape, src->ndim),
                             at::IntArrayRef(src->strides, src->ndim),
                             torch::device(device).dtype(stype));
 }
@@ -186,7 +192,8 @@ extern "C" void torchTensorFromRAITensor(RAI_Tensor *src, void *torch_tensor) {
     // Create torch tensor with the tensor's blob, and send a deleter callback
     // for torch to use to release the RAI_Tensor when it finishes.
     *static_cast<torch::Tensor *>(torch_tensor) = torch::Tensor(
-        torch::from_blob(dl_tensor->data, at::IntArrayRef(dl_tensor->shape, dl_tensor->ndim),
+        torch::from_blob(static_cast<char *>(dl_tensor->data) + dl_tensor->byte_offset,
+                         at::IntArrayRef(dl_tensor->shape, dl_tensor->ndim),
                          at::IntArrayRef(dl_tensor->strides, dl_tensor->ndim), free_tensor,
                          torch::device(device).dtype(stype)));
 }
@@ -226,18 +233,71 @@ extern "C" DLManagedTensor *torchTensorPtrToManagedDLPack(const void *src) {
     return toManagedDLPack(*static_cast<const torch::Tensor *>(src));
 }
 
+struct FunctionInfo {
+    torch::jit::Function *function;
+    std::vector<TorchScriptFunctionArgumentType> argTypes;
+};
+
 struct ModuleContext {
     std::shared_ptr<torch::jit::script::Module> module;
     std::shared_ptr<torch::jit::script::CompilationUnit> cu;
     DLDeviceType device;
     int64_t device_id;
+    // The functions of the script (or the methods of the model), resolved once when the
+    // context is created, so that runs don't look them up and inspect their schemas.
+    std::unordered_map<std::string, FunctionInfo> functions;
 };
 
+static void addFunctionInfo(ModuleContext *ctx, torch::jit::Function &function) {
+    FunctionInfo info;
+    info.function = &function;
+    for (const auto &arg : function.getSchema().arguments()) {
+        info.argTypes.push_back(getArgumentType(arg));
+    }
+    ctx->functions.emplace(function.name(), std::move(info));
+}
+
+static void resolveFunctions(ModuleContext *ctx) {
+    if (ctx->module) {
+        for (const auto &method : ctx->module->get_methods()) {
+            addFunctionInfo(ctx, method.function());
+        }
+    } else {
+        for (torch::jit::Function *function : ctx->cu->get_functions()) {
+            addFunctionInfo(ctx, *function);
+        }
+    }
+}
+
+static const FunctionInfo *findFunction(ModuleContext *ctx, const char *fnName) {
+    auto it = ctx->functions.find(fnName);
+    if (it == ctx->functions.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+static std::atomic<unsigned long long> outputs_copied(0);
+static std::atomic<unsigned long long> outputs_copies_saved(0);
+
+// RedisAI tensors are dense, row-major CPU tensors. An output that is already such a tensor is
+// handed back as is, sharing its storage. Otherwise, it is materialized with a single copy that
+// moves it to the CPU and makes it contiguous at once, whereas a non-contiguous output on
+// another device used to be copied twice (by contiguous() on its device, and then to the CPU).
+static DLManagedTensor *toOutputDLPack(const torch::Tensor &t) {
+    if (t.device().is_cpu() && t.is_contiguous()) {
+        return toManagedDLPack(t);
+    }
+    outputs_copied++;
+    if (!t.device().is_cpu() && !t.is_contiguous()) {
+        outputs_copies_saved++;
+    }
+    return toManagedDLPack(t.to(torch::kCPU, t.scalar_type(), /*non_blocking=*/false,
+                                /*copy=*/false, c10::MemoryFormat::Contiguous));
+}
+
 static void torchHandlOutputs(torch::jit::Stack &stack, const char *fnName, long nOutputs,
                               DLManagedTensor **outputs) {
-    torch::DeviceType output_device_type = torch::kCPU;
-    torch::Device output_device(output_device_type, -1);
-
     if (nOutputs == 0)
         return;
     int count = 0;
@@ -248,18 +308,17 @@ static void torchHandlOutputs(torch::jit::Stack &stack, const char *fnName, long
         }
 
         if (stack[i].isTensor()) {
-            outputs[count++] = toManagedDLPack(stack[i].toTensor().contiguous().to(output_device));
+            outputs[count++] = toOutputDLPack(stack[i].toTensor());
         } else if (stack[i].isTensorList()) {
             auto list = stack[i].toTensorList();
             for (size_t j = 0; j < list.size(); j++) {
-                outputs[count++] = toManagedDLPack(list.get(j).contiguous().to(output_device));
+                outputs[count++] = toOutputDLPack(list.get(j));
             }
         } else if (stack[i].isTuple()) {
             auto &elements = stack[i].toTuple()->elements();
             for (size_t j = 0; j < elements.size(); j++) {
                 if (elements[j].isTensor()) {
-                    outputs[count++] =
-                        toManagedDLPack(elements[j].toTensor().contiguous().to(output_device));
+                    outputs[count++] = toOutputDLPack(elements[j].toTensor());
                 } else {
                     throw std::runtime_error(std::string("Function returned non-tensor values") +
                                              fnName);
@@ -279,15 +338,16 @@ static void torchHandlOutputs(torch::jit::Stack &stack, const char *fnName, long
 void torchRunModule(ModuleContext *ctx, const char *fnName, torch::jit::Stack &stack, long nOutputs,
                     DLManagedTensor **outputs) {
 
+    const FunctionInfo *info = findFunction(ctx, fnName);
+    if (!info) {
+        throw std::runtime_error(std::string("Function does not exist: ") + fnName);
+    }
+    torch::NoGradGuard guard;
     if (ctx->module) {
-        torch::NoGradGuard guard;
-        torch::jit::script::Method method = ctx->module->get_method(fnName);
-        method.run(stack);
-    } else {
-        torch::NoGradGuard guard;
-        torch::jit::Function &fn = ctx->cu->get_function(fnName);
-        fn.run(stack);
+        // A method expects the module object as its first (self) argument.
+        stack.insert(stack.begin(), ctx->module->_ivalue());
     }
+    info->function->run(stack);
 
     torchHandlOutputs(stack, fnName, nOutputs, outputs);
 }
@@ -309,6 +369,7 @@ extern "C" void *torchCompileScript(const char *script, DLDeviceType device, int
         }
         ctx->cu = cu;
         ctx->module = nullptr;
+        resolveFunctions(ctx);
 
     } catch (std::exception &e) {
         *error = RedisModule_Strdup(e.what());
@@ -336,6 +397,7 @@ extern "C" void *torchLoadModel(const char *graph, size_t graphlen, DLDeviceType
         module->to(aten_device);
         ctx->module = module;
         ctx->cu = nullptr;
+        resolveFunctions(ctx);
     } catch (std::exception &e) {
         *error = RedisModule_Strdup(e.what());
         delete ctx;
@@ -370,17 +432,17 @@ extern "C" void torchRunScript(void *scriptCtx, const char *fnName,
              * by SCRIPTRUN or SCRIPTEXECUTE, and those functions are not in the endpoint set to be
              * executed in "best effort" manner.
              */
-            if (!torchScript_FunctionExists(ctx, fnName)) {
+            const FunctionInfo *info = findFunction(ctx, fnName);
+            if (!info) {
                 throw std::runtime_error(std::string("Function does not exist: ") + fnName);
             }
-            size_t nArgs = torchScript_FunctionArgumentCountByFunctionName(ctx, fnName);
+            size_t nArgs = info->argTypes.size();
             if (nArgs > inputsCtx->tensorCount) {
                 throw std::runtime_error(
                     std::string("Wrong number of inputs provided to function: ") + fnName);
             }
             for (size_t i = 0; i < nArgs; i++) {
-                TorchScriptFunctionArgumentType argType =
-                    torchScript_FunctionArgumentTypeByFunctionName(ctx, fnName, i);
+                TorchScriptFunctionArgumentType argType = info->argTypes[i];
                 // Argument can be either a tensor or a tensor list.
                 if ((argType != TENSOR && argType != TENSOR_LIST)) {
                     throw std::runtime_error(
@@ -449,12 +511,28 @@ extern "C" void torchRunModel(void *modelCtx, long nInputs, DLManagedTensor **in
         torch::Device device(device_type, ctx->device_id);
 
         torch::jit::Stack stack;
+        std::vector<torch::Tensor> input_tensors;
         for (int i = 0; i < nInputs; i++) {
             DLTensor *input = &(inputs[i]->dl_tensor);
             torch::Tensor tensor = fromDLPack(input);
+            input_tensors.push_back(tensor);
             stack.push_back(tensor.to(device));
         }
         torchRunModule(ctx, "forward", stack, nOutputs, outputs);
+
+        // Inputs wrap their blobs without copying, and these blobs may be reused by the next
+        // batched run once this run is done. Hence, outputs which alias an input are copied.
+        for (long i = 0; i < nOutputs; i++) {
+            auto *atDLMTensor = static_cast<ATenDLMTensor *>(outputs[i]->manager_ctx);
+            for (auto &input : input_tensors) {
+                if (atDLMTensor->handle.storage().is_alias_of(input.storage())) {
+                    outputs_copied++;
+                    outputs[i] = toManagedDLPack(atDLMTensor->handle.clone());
+                    delete atDLMTensor;
+                    break;
+                }
+            }
+        }
     } catch (std::exception &e) {
         *error = RedisModule_Strdup(e.what());
     }
@@ -620,20 +698,21 @@ extern "C" const char *torchScript_FunctionName(void *scriptCtx, size_t fn_index
 extern "C" size_t torchScript_FunctionArgumentCountByFunctionName(void *scriptCtx,
                                                                   const char *functionName) {
     ModuleContext *ctx = (ModuleContext *)scriptCtx;
-    torch::jit::Function *function = ctx->cu->find_function(functionName);
-    return function->getSchema().arguments().size();
+    return findFunction(ctx, functionName)->argTypes.size();
 }
 
 extern "C" TorchScriptFunctionArgumentType
 torchScript_FunctionArgumentTypeByFunctionName(void *scriptCtx, const char *functionName,
                                                size_t arg_index) {
     ModuleContext *ctx = (ModuleContext *)scriptCtx;
-    torch::jit::Function *function = ctx->cu->find_function(functionName);
-    return getArgumentType(function->getSchema().arguments()[arg_index]);
+    return findFunction(ctx, functionName)->argTypes[arg_index];
 }
 
 extern "C" bool torchScript_FunctionExists(void *scriptCtx, const char *functionName) {
     ModuleContext *ctx = (ModuleContext *)scriptCtx;
-    torch::jit::Function *function = ctx->cu->find_function(functionName);
-    return function != nullptr;
+    return findFunction(ctx, functionName) != nullptr;
 }
+
+extern "C" unsigned long long torchOutputsCopied() { return outputs_copied; }
+
+extern "C" unsigned long long torchOutputsCopiesSaved() { return outputs_copies_saved; }
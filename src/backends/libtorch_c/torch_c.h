@@ -210,6 +210,18 @@ DLManagedTensor *torchTensorPtrToManagedDLPack(const void *src);
  */
 void torchTensorFromRAITensor(RAI_Tensor *src, void *torch_tensor);
 
+/**
+ * @brief Returns the number of output tensors that had to be copied, since they
+ * were not dense CPU tensors (or aliased a model input).
+ */
+unsigned long long torchOutputsCopied(void);
+
+/**
+ * @brief Returns the number of output tensors that were materialized with a single
+ * copy rather than two, since they were neither contiguous nor on the CPU.
+ */
+unsigned long long torchOutputsCopiesSaved(void);
+
 #ifdef __cplusplus
 }
 #endif
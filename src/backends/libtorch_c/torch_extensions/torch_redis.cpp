@@ -14,10 +14,15 @@
 static torch::RegisterOperators registry;
 void registerRedisOps(void) {
     registry = torch::RegisterOperators("redis::execute", &redisExecute)
+                   .op("redis::execute_many", &redisExecuteMany)
                    .op("redis::asList", &asList)
-                   .op("redisAI::model_execute", &modelExecute);
+                   .op("redisAI::model_execute", &modelExecute)
+                   .op("redisAI::tensor_get", &tensorGet)
+                   .op("redisAI::tensor_set", &tensorSet);
 }
 
+// Converts a reply to an IValue, throwing if the reply is an error. The caller remains the owner
+// of the reply and of the context.
 torch::IValue IValueFromRedisReply(RedisModuleCtx *ctx, RedisModuleCallReply *reply) {
 
     int reply_type = RedisModule_CallReplyType(reply);
@@ -28,8 +33,7 @@ torch::IValue IValueFromRedisReply(RedisModuleCtx *ctx, RedisModuleCallReply *re
     case REDISMODULE_REPLY_STRING: {
         size_t len;
         const char *replyStr = RedisModule_CallReplyStringPtr(reply, &len);
-        std::string str = replyStr;
-        return torch::IValue(str.substr(0, len));
+        return torch::IValue(std::string(replyStr, len));
     }
     case REDISMODULE_REPLY_INTEGER: {
         int intValue = (int)RedisModule_CallReplyInteger(reply);
@@ -48,18 +52,15 @@ torch::IValue IValueFromRedisReply(RedisModuleCtx *ctx, RedisModuleCallReply *re
     case REDISMODULE_REPLY_ERROR: {
         size_t len;
         const char *replyStr = RedisModule_CallReplyStringPtr(reply, &len);
-        std::string error_str = "Redis command returned an error: " + std::string(replyStr);
-        RedisModule_FreeCallReply(reply);
-        RedisModule_FreeThreadSafeContext(ctx);
+        std::string error_str =
+            "Redis command returned an error: " + std::string(replyStr, len);
         throw std::runtime_error(error_str);
     }
     case REDISMODULE_REPLY_UNKNOWN: {
         std::string error_str = "Redis command returned an error: " + std::string(strerror(errno));
-        RedisModule_FreeThreadSafeContext(ctx);
         throw(std::runtime_error(error_str));
     }
     default: {
-        RedisModule_FreeThreadSafeContext(ctx);
         throw(std::runtime_error("Unexpected internal error"));
     }
     }
@@ -80,12 +81,74 @@ torch::IValue redisExecute(const std::string &fn_name, const std::vector<std::st
     for (int i = 0; i < len; i++) {
         RedisModule_FreeString(nullptr, arguments[i]);
     }
-    torch::IValue value = IValueFromRedisReply(ctx, reply);
+    torch::IValue value;
+    try {
+        value = IValueFromRedisReply(ctx, reply);
+    } catch (std::exception &e) {
+        if (reply) {
+            RedisModule_FreeCallReply(reply);
+        }
+        RedisModule_FreeThreadSafeContext(ctx);
+        throw;
+    }
     RedisModule_FreeCallReply(reply);
     RedisModule_FreeThreadSafeContext(ctx);
     return value;
 }
 
+torch::List<torch::IValue> redisExecuteMany(const std::vector<std::vector<std::string>> &commands) {
+    for (auto &command : commands) {
+        if (command.empty()) {
+            throw std::runtime_error("Redis command is missing in execute_many");
+        }
+    }
+    // Create the arguments before taking the lock, and run all the commands while holding
+    // the lock once, so that the script doesn't contend with the main thread per command.
+    std::vector<std::vector<RedisModuleString *>> arguments(commands.size());
+    for (size_t i = 0; i < commands.size(); i++) {
+        for (size_t j = 1; j < commands[i].size(); j++) {
+            const std::string &arg = commands[i][j];
+            arguments[i].push_back(RedisModule_CreateString(nullptr, arg.data(), arg.size()));
+        }
+    }
+    std::vector<RedisModuleCallReply *> replies(commands.size());
+    RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(nullptr);
+    RedisModule_ThreadSafeContextLock(ctx);
+    for (size_t i = 0; i < commands.size(); i++) {
+        replies[i] = RedisModule_Call(ctx, commands[i][0].c_str(), "!v", arguments[i].data(),
+                                      arguments[i].size());
+    }
+    RedisModule_ThreadSafeContextUnlock(ctx);
+    for (auto &command_arguments : arguments) {
+        for (RedisModuleString *arg : command_arguments) {
+            RedisModule_FreeString(nullptr, arg);
+        }
+    }
+
+    // Convert the replies without holding the lock.
+    torch::List<torch::IValue> values(c10::AnyType::get());
+    bool failed = false;
+    std::string error;
+    for (RedisModuleCallReply *reply : replies) {
+        if (!failed) {
+            try {
+                values.push_back(IValueFromRedisReply(ctx, reply));
+            } catch (std::exception &e) {
+                failed = true;
+                error = e.what();
+            }
+        }
+        if (reply) {
+            RedisModule_FreeCallReply(reply);
+        }
+    }
+    RedisModule_FreeThreadSafeContext(ctx);
+    if (failed) {
+        throw std::runtime_error(error);
+    }
+    return values;
+}
+
 torch::List<torch::IValue> asList(const torch::IValue &v) { return v.toList(); }
 
 std::vector<torch::Tensor> modelExecute(const std::string &model_key,
@@ -152,3 +215,72 @@ finish:
     RedisAI_FreeError(err);
     return outputs;
 }
+
+torch::Tensor tensorGet(const std::string &key_name) {
+    RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(nullptr);
+    RedisModuleString *key_name_rs =
+        RedisModule_CreateString(nullptr, key_name.data(), key_name.size());
+    RAI_Error *err;
+    RedisAI_InitError(&err);
+    RedisModuleKey *key;
+    RAI_Tensor *tensor = nullptr;
+
+    RedisModule_ThreadSafeContextLock(ctx);
+    int status =
+        RedisAI_TensorGetFromKeyspace(ctx, key_name_rs, &key, &tensor, REDISMODULE_READ, err);
+    if (status == REDISMODULE_OK) {
+        // Hold a reference to the tensor, so it outlives its key if the key is overwritten or
+        // deleted while the script still uses it.
+        RedisAI_TensorGetShallowCopy(tensor);
+    }
+    RedisModule_ThreadSafeContextUnlock(ctx);
+    RedisModule_FreeString(nullptr, key_name_rs);
+    RedisModule_FreeThreadSafeContext(ctx);
+    if (status != REDISMODULE_OK) {
+        std::string error = RedisAI_GetError(err);
+        RedisAI_FreeError(err);
+        throw std::runtime_error(error);
+    }
+    RedisAI_FreeError(err);
+
+    // The script gets a copy of the tensor, since modifying the key's blob in place would bypass
+    // keyspace notifications and replication. The torch tensor that wraps the blob releases the
+    // reference once it is freed.
+    torch::Tensor shared;
+    try {
+        torchTensorFromRAITensor(tensor, static_cast<void *>(&shared));
+    } catch (std::exception &e) {
+        RedisAI_TensorFree(tensor);
+        throw;
+    }
+    return shared.clone();
+}
+
+void tensorSet(const std::string &key_name, const torch::Tensor &tensor) {
+    // The key stores a copy of the tensor, since the script may keep modifying the tensor (or
+    // another view of its storage) after storing it. A single copy also moves the tensor to the
+    // CPU and makes it dense.
+    torch::Tensor dense = tensor.to(torch::kCPU, tensor.scalar_type(), /*non_blocking=*/false,
+                                    /*copy=*/true, c10::MemoryFormat::Contiguous);
+    RAI_Tensor *rai_tensor = RedisAI_TensorCreateFromDLTensor(torchTensorPtrToManagedDLPack(&dense));
+
+    RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(nullptr);
+    RedisModuleString *key_name_rs =
+        RedisModule_CreateString(nullptr, key_name.data(), key_name.size());
+    RAI_Error *err;
+    RedisAI_InitError(&err);
+
+    RedisModule_ThreadSafeContextLock(ctx);
+    int status = RedisAI_TensorSetInKeyspace(ctx, key_name_rs, rai_tensor, err);
+    RedisModule_ThreadSafeContextUnlock(ctx);
+    RedisModule_FreeString(nullptr, key_name_rs);
+    RedisModule_FreeThreadSafeContext(ctx);
+    if (status != REDISMODULE_OK) {
+        // The key did not take ownership of the tensor.
+        RedisAI_TensorFree(rai_tensor);
+        std::string error = RedisAI_GetError(err);
+        RedisAI_FreeError(err);
+        throw std::runtime_error(error);
+    }
+    RedisAI_FreeError(err);
+}
@@ -35,10 +35,13 @@ inline std::shared_ptr<RedisResolver> redisResolver() { return std::make_shared<
 } // namespace torch
 
 torch::IValue redisExecute(const std::string &fn_name, const std::vector<std::string> &args);
+torch::List<torch::IValue> redisExecuteMany(const std::vector<std::vector<std::string>> &commands);
 torch::List<torch::IValue> asList(const torch::IValue &v);
 std::vector<torch::Tensor> modelExecute(const std::string &model_key,
                                         const std::vector<torch::Tensor> &inputs,
                                         int64_t num_outputs);
+torch::Tensor tensorGet(const std::string &key_name);
+void tensorSet(const std::string &key_name, const torch::Tensor &tensor);
 
 // Register Redis and RedisAI costume ops in torch
 void registerRedisOps(void);
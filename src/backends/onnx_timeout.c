@@ -13,6 +13,13 @@
 #include "redis_ai_objects/stats.h"
 #include "backends_api.h"
 
+// Every entry owns a single OrtRunOptions for the lifetime of its working thread, so that
+// we don't have to create and release one for every run.
+static void _CreateRunOptions(OnnxRunSessionCtx *entry) {
+    const OrtApi *ort = OrtGetApiBase()->GetApi(1);
+    RedisModule_Assert(ort->CreateRunOptions(&entry->runOptions) == NULL);
+}
+
 int RAI_InitGlobalRunSessionsORT() {
     onnx_global_run_sessions = RedisModule_Alloc(sizeof(OnnxGlobalRunSessions));
 
@@ -26,6 +33,7 @@ int RAI_InitGlobalRunSessionsORT() {
         entry->runState = RedisModule_Alloc(sizeof(entry->runState));
         *entry->runState = RUN_SESSION_AVAILABLE;
         entry->queuingTime = LLONG_MAX;
+        _CreateRunOptions(entry);
         run_sessions_array = array_append(run_sessions_array, entry);
     }
     onnx_global_run_sessions->OnnxRunSessions = run_sessions_array;
@@ -55,6 +63,7 @@ int RAI_AddNewDeviceORT(const char *device_str) {
         entry->runState = RedisModule_Alloc(sizeof(entry->runState));
         *entry->runState = RUN_SESSION_AVAILABLE;
         entry->queuingTime = LLONG_MAX;
+        _CreateRunOptions(entry);
         run_sessions_array = array_append(run_sessions_array, entry);
     }
     onnx_global_run_sessions->OnnxRunSessions = run_sessions_array;
@@ -90,7 +99,7 @@ void RAI_EnforceTimeoutORT(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t s
     pthread_rwlock_unlock(&(onnx_global_run_sessions->rwlock));
 }
 
-void RAI_ActivateRunSessionCtxORT(OrtRunOptions *new_run_options, long *run_session_index) {
+OrtRunOptions *RAI_ActivateRunSessionCtxORT(long *run_session_index) {
 
     pthread_rwlock_rdlock(&(onnx_global_run_sessions->rwlock));
     // Get the thread id (which is the correspondent index in the global sessions array + 1).
@@ -98,17 +107,18 @@ void RAI_ActivateRunSessionCtxORT(OrtRunOptions *new_run_options, long *run_sess
     *run_session_index = RedisAI_GetThreadId();
     if (*run_session_index == -1) {
         pthread_rwlock_unlock(&(onnx_global_run_sessions->rwlock));
-        return;
+        return NULL;
     }
     OnnxRunSessionCtx *entry = onnx_global_run_sessions->OnnxRunSessions[*run_session_index];
     RedisModule_Assert(*entry->runState == RUN_SESSION_AVAILABLE);
     RedisModule_Assert(entry->queuingTime == LLONG_MAX);
 
     // Update the entry with the current session data.
-    entry->runOptions = new_run_options;
+    OrtRunOptions *run_options = entry->runOptions;
     __atomic_store_n(&(entry->queuingTime), mstime(), __ATOMIC_RELAXED);
     __atomic_store_n(entry->runState, RUN_SESSION_ACTIVE, __ATOMIC_RELAXED);
     pthread_rwlock_unlock(&(onnx_global_run_sessions->rwlock));
+    return run_options;
 }
 
 void RAI_ResetRunSessionCtxORT(long run_session_index) {
@@ -124,8 +134,10 @@ void RAI_ResetRunSessionCtxORT(long run_session_index) {
         while (!__sync_bool_compare_and_swap(entry->runState, RUN_SESSION_TERMINATED,
                                              RUN_SESSION_AVAILABLE))
             ;
+        // The run options are reused by the next run on this thread, so clear the
+        // termination flag that the cron callback has set.
+        RedisModule_Assert(ort->RunOptionsUnsetTerminate(entry->runOptions) == NULL);
     }
     __atomic_store_n(&(entry->queuingTime), LLONG_MAX, __ATOMIC_RELAXED);
-    ort->ReleaseRunOptions(entry->runOptions);
     pthread_rwlock_unlock(&(onnx_global_run_sessions->rwlock));
 }
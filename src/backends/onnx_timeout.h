@@ -73,17 +73,19 @@ void RAI_EnforceTimeoutORT(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t s
                            void *data);
 
 /**
- * @brief Set a new OrtRunOptions in the global structure, to allow us to
+ * @brief Mark the run session entry of the current thread as active, to allow us to
  * "terminate" the run session from the cron callback.
- * @param new_run_options - The newly created OrtRunOptions to store.
  * @param run_session_index - placeholder for the index of the running thread
  * in the global array, to have a quick access later to clean this entry.
+ * @return The OrtRunOptions owned by the current thread's entry, to be used for the run,
+ * or NULL if we are not running from a RedisAI working thread (index is set to -1).
  */
-void RAI_ActivateRunSessionCtxORT(OrtRunOptions *new_run_options, long *run_session_index);
+OrtRunOptions *RAI_ActivateRunSessionCtxORT(long *run_session_index);
 
 /**
- * @brief Release the OrtRunOptions of a session that finished its run and
- * reset the corresponding entry in the global structure.
+ * @brief Reset the entry of a session that finished its run in the global structure.
+ * The entry's OrtRunOptions is kept for the next run (its termination flag is cleared
+ * if the run was terminated due to a timeout).
  * @param run_session_index - The entry index where OrtRunOptions was stored.
  */
 void RAI_ResetRunSessionCtxORT(long run_session_index);
@@ -24,6 +24,9 @@
         goto error;
 
 OrtEnv *env = NULL;
+// Models may be created concurrently (by AI.MODELSTORE background threads), so the
+// environment is created under this lock.
+static pthread_mutex_t env_lock = PTHREAD_MUTEX_INITIALIZER;
 
 // For model that run on GPU, onnx will not use the custom allocator (redis allocator), but
 // the onnx allocator for GPU. But for the auxiliary allocations of the input and output names,
@@ -215,7 +218,7 @@ int RAI_OrtValueFromTensors(RAI_Tensor **ts, size_t batches_count, OrtValue **in
         }
     } else {
         ONNX_VALIDATE_STATUS(ort->CreateTensorWithDataAsOrtValue(
-            global_allocator->Info(global_allocator), t0->tensor.dl_tensor.data,
+            global_allocator->Info(global_allocator), RAI_TensorData(t0),
             RAI_TensorByteSize(t0), t0->tensor.dl_tensor.shape, t0->tensor.dl_tensor.ndim,
             RAI_GetOrtDataTypeFromDL(t0->tensor.dl_tensor.dtype), &out))
     }
@@ -326,12 +329,89 @@ error:
     return NULL;
 }
 
+// Static description of a model output, cached when the model is created. If every output
+// of a model that runs on CPU is a numeric tensor with a fully known shape, the outputs
+// are pre-allocated as RAI_Tensors and bound to the session (via IoBinding), so that ORT
+// writes the results directly into the tensors' memory.
+typedef struct OrtOutputSpec {
+    DLDataType dtype;
+    size_t ndims;
+    int64_t *dims;
+} OrtOutputSpec;
+
+static void _ORTFreeOutputSpecs(OrtOutputSpec *specs) {
+    if (specs == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < array_len(specs); i++) {
+        RedisModule_Free(specs[i].dims);
+    }
+    array_free(specs);
+}
+
+// Sets *specs_ptr to the outputs' specs if all of them are static, or to NULL otherwise.
+static int _ORTGetStaticOutputSpecs(OrtSession *session, size_t n_outputs,
+                                    OrtOutputSpec **specs_ptr, OrtStatus **status_ptr) {
+    OrtStatus *status = NULL;
+    const OrtApi *ort = OrtGetApiBase()->GetApi(1);
+    OrtTypeInfo *type_info = NULL;
+    OrtOutputSpec *specs = array_new(OrtOutputSpec, n_outputs);
+    *specs_ptr = NULL;
+
+    for (size_t i = 0; i < n_outputs; i++) {
+        ONNX_VALIDATE_STATUS(ort->SessionGetOutputTypeInfo(session, i, &type_info))
+        enum ONNXType onnx_type;
+        ONNX_VALIDATE_STATUS(ort->GetOnnxTypeFromTypeInfo(type_info, &onnx_type))
+        if (onnx_type != ONNX_TYPE_TENSOR) {
+            goto dynamic;
+        }
+        const OrtTensorTypeAndShapeInfo *info;
+        ONNX_VALIDATE_STATUS(ort->CastTypeInfoToTensorInfo(type_info, &info))
+        ONNXTensorElementDataType ort_dtype;
+        ONNX_VALIDATE_STATUS(ort->GetTensorElementType(info, &ort_dtype))
+        DLDataType dtype = RAI_GetDLDataTypeFromORT(ort_dtype);
+        size_t ndims;
+        ONNX_VALIDATE_STATUS(ort->GetDimensionsCount(info, &ndims))
+        if (dtype.bits == 0 || dtype.code == kDLString || ndims == 0) {
+            goto dynamic;
+        }
+        OrtOutputSpec spec = {.dtype = dtype, .ndims = ndims};
+        spec.dims = RedisModule_Alloc(ndims * sizeof(*spec.dims));
+        specs = array_append(specs, spec);
+        ONNX_VALIDATE_STATUS(ort->GetDimensions(info, spec.dims, ndims))
+        for (size_t j = 0; j < ndims; j++) {
+            // Symbolic/unknown dimensions are reported as -1.
+            if (spec.dims[j] <= 0) {
+                goto dynamic;
+            }
+        }
+        ort->ReleaseTypeInfo(type_info);
+        type_info = NULL;
+    }
+    *specs_ptr = specs;
+    return REDISMODULE_OK;
+
+dynamic:
+    ort->ReleaseTypeInfo(type_info);
+    _ORTFreeOutputSpecs(specs);
+    return REDISMODULE_OK;
+
+error:
+    *status_ptr = status;
+    if (type_info) {
+        ort->ReleaseTypeInfo(type_info);
+    }
+    _ORTFreeOutputSpecs(specs);
+    return REDISMODULE_ERR;
+}
+
 RAI_Model *RAI_ModelCreateORT(RAI_Backend backend, const char *devicestr, RAI_ModelOpts opts,
                               const char *modeldef, size_t modellen, RAI_Error *error) {
 
     const OrtApi *ort = OrtGetApiBase()->GetApi(1);
     char **inputs_ = NULL;
     char **outputs_ = NULL;
+    OrtOutputSpec *output_specs = NULL;
     OrtSessionOptions *session_options = NULL;
     OrtSession *session = NULL;
     OrtStatus *status = NULL;
@@ -340,10 +420,17 @@ RAI_Model *RAI_ModelCreateORT(RAI_Backend backend, const char *devicestr, RAI_Mo
     // an allocator to it that uses Redis allocator. This allocator is going to be used for
     // allocating buffers when creating and running models that run on CPU, and for allocations of
     // models inputs and outputs names (for both models that run on CPU and GPU)
+    pthread_mutex_lock(&env_lock);
     if (env == NULL) {
-        ONNX_VALIDATE_STATUS(ort->CreateEnv(ORT_LOGGING_LEVEL_WARNING, "RedisAI", &env))
-        global_allocator = CreateCustomAllocator(RedisAI_GetMemoryLimit());
-        ONNX_VALIDATE_STATUS(ort->RegisterAllocator(env, global_allocator))
+        status = ort->CreateEnv(ORT_LOGGING_LEVEL_WARNING, "RedisAI", &env);
+        if (status == NULL) {
+            global_allocator = CreateCustomAllocator(RedisAI_GetMemoryLimit());
+            status = ort->RegisterAllocator(env, global_allocator);
+        }
+    }
+    pthread_mutex_unlock(&env_lock);
+    if (status != NULL) {
+        goto error;
     }
 
     ONNX_VALIDATE_STATUS(ort->CreateSessionOptions(&session_options))
@@ -392,6 +479,14 @@ RAI_Model *RAI_ModelCreateORT(RAI_Backend backend, const char *devicestr, RAI_Mo
         outputs_ = array_append(outputs_, output_name);
     }
 
+    // Output buffers can be pre-allocated by us only when ORT runs the model on CPU.
+    if (strcasecmp(devicestr, "CPU") == 0) {
+        if (_ORTGetStaticOutputSpecs(session, n_output_nodes, &output_specs, &status) !=
+            REDISMODULE_OK) {
+            goto error;
+        }
+    }
+
     // Since ONNXRuntime doesn't have a re-serialization function,
     // we cache the blob in order to re-serialize it.
     // Not optimal for storage purposes, but again, it may be temporary
@@ -399,7 +494,7 @@ RAI_Model *RAI_ModelCreateORT(RAI_Backend backend, const char *devicestr, RAI_Mo
     memcpy(buffer, modeldef, modellen);
 
     RAI_Model *ret = RedisModule_Calloc(1, sizeof(*ret));
-    ret->model = NULL;
+    ret->model = output_specs;
     ret->session = session;
     ret->backend = backend;
     ret->devicestr = RedisModule_Strdup(devicestr);
@@ -457,6 +552,7 @@ void RAI_ModelFreeORT(RAI_Model *model, RAI_Error *error) {
     RedisModule_Free(model->devicestr);
     RedisModule_Free(model->data);
     ort->ReleaseSession(model->session);
+    _ORTFreeOutputSpecs(model->model);
     model->model = NULL;
     model->session = NULL;
     return;
@@ -498,18 +594,19 @@ int RAI_ModelRunORT(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *error
     }
 
     OrtStatus *status = NULL;
-    array_new_on_stack(const char *, 5, input_names);
-    array_new_on_stack(const char *, 5, output_names);
     array_new_on_stack(OrtValue *, 5, inputs);
     array_new_on_stack(OrtValue *, 5, outputs);
+    array_new_on_stack(RAI_Tensor *, 5, output_tensors);
+    OrtIoBinding *io_binding = NULL;
     OrtRunOptions *run_options = NULL;
     long run_session_index;
     OrtTensorTypeAndShapeInfo *info = NULL;
     {
-        size_t n_input_nodes;
-        size_t n_output_nodes;
-        ONNX_VALIDATE_STATUS(ort->SessionGetInputCount(session, &n_input_nodes))
-        ONNX_VALIDATE_STATUS(ort->SessionGetOutputCount(session, &n_output_nodes))
+        // The input and output names were fetched from the session once, upon model creation.
+        const size_t n_input_nodes = model->ninputs;
+        const size_t n_output_nodes = model->noutputs;
+        const char *const *input_names = (const char *const *)model->inputs;
+        const char *const *output_names = (const char *const *)model->outputs;
 
         if (n_inputs != n_input_nodes) {
             char msg[70];
@@ -526,11 +623,6 @@ int RAI_ModelRunORT(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *error
         }
 
         for (size_t i = 0; i < n_input_nodes; i++) {
-            char *input_name;
-            ONNX_VALIDATE_STATUS(
-                ort->SessionGetInputName(session, i, global_allocator, &input_name))
-            input_names = array_append(input_names, input_name);
-
             RAI_Tensor *batched_input_tensors[n_batches];
             for (size_t b = 0; b < n_batches; b++) {
                 batched_input_tensors[b] = RAI_ExecutionCtx_GetInput(ectxs[b], i);
@@ -543,40 +635,71 @@ int RAI_ModelRunORT(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *error
             inputs = array_append(inputs, input);
         }
 
-        for (size_t i = 0; i < n_output_nodes; i++) {
-            char *output_name;
-            ONNX_VALIDATE_STATUS(
-                ort->SessionGetOutputName(session, i, global_allocator, &output_name))
-            output_names = array_append(output_names, output_name);
-            outputs = array_append(outputs, NULL);
+        // If the outputs' shapes are static (and there is a single batch, so no split is
+        // needed), let ORT write the outputs directly into pre-allocated RAI_Tensors.
+        OrtOutputSpec *output_specs = RAI_ModelGetModel(model);
+        const bool bind_outputs = output_specs != NULL && n_batches == 1;
+        if (bind_outputs) {
+            ONNX_VALIDATE_STATUS(ort->CreateIoBinding(session, &io_binding))
+            for (size_t i = 0; i < n_input_nodes; i++) {
+                ONNX_VALIDATE_STATUS(ort->BindInput(io_binding, input_names[i], inputs[i]))
+            }
+            for (size_t i = 0; i < n_output_nodes; i++) {
+                OrtOutputSpec *spec = &output_specs[i];
+                RAI_Tensor *output_tensor =
+                    RAI_TensorNew(spec->dtype, (const size_t *)spec->dims, (int)spec->ndims);
+                output_tensor->tensor.dl_tensor.data =
+                    RedisModule_Alloc(RAI_TensorByteSize(output_tensor));
+                output_tensors = array_append(output_tensors, output_tensor);
+
+                OrtValue *output;
+                ONNX_VALIDATE_STATUS(ort->CreateTensorWithDataAsOrtValue(
+                    global_allocator->Info(global_allocator), RAI_TensorData(output_tensor),
+                    RAI_TensorByteSize(output_tensor), spec->dims, spec->ndims,
+                    RAI_GetOrtDataTypeFromDL(spec->dtype), &output))
+                outputs = array_append(outputs, output);
+                ONNX_VALIDATE_STATUS(ort->BindOutput(io_binding, output_names[i], output))
+            }
+        } else {
+            for (size_t i = 0; i < n_output_nodes; i++) {
+                outputs = array_append(outputs, NULL);
+            }
         }
 
-        ONNX_VALIDATE_STATUS(ort->CreateRunOptions(&run_options));
-        // Set the created run option in the global RunSessions and save its index.
-        RAI_ActivateRunSessionCtxORT(run_options, &run_session_index);
-        if (run_session_index == -1) {
+        // Get the run options of this thread, and save the index of its entry in the
+        // global RunSessions.
+        run_options = RAI_ActivateRunSessionCtxORT(&run_session_index);
+        if (run_options == NULL) {
             RAI_SetError(
                 error, RAI_EMODELRUN,
                 "Cannot execute onnxruntime model synchronously, use async execution instead");
-            ort->ReleaseRunOptions(run_options);
-            run_options = NULL;
             goto error;
         }
 
-        ONNX_VALIDATE_STATUS(ort->Run(session, run_options, input_names,
-                                      (const OrtValue *const *)inputs, n_input_nodes, output_names,
-                                      n_output_nodes, outputs));
+        if (bind_outputs) {
+            ONNX_VALIDATE_STATUS(ort->RunWithBinding(session, run_options, io_binding))
+        } else {
+            ONNX_VALIDATE_STATUS(ort->Run(session, run_options, input_names,
+                                          (const OrtValue *const *)inputs, n_input_nodes,
+                                          output_names, n_output_nodes, outputs));
+        }
         RAI_ResetRunSessionCtxORT(run_session_index);
         run_options = NULL;
 
-        for (uint32_t i = 0; i < n_inputs; i++) {
-            status = ort->AllocatorFree(global_allocator, (void *)input_names[i]);
-        }
-        array_free(input_names);
-        for (uint32_t i = 0; i < n_outputs; i++) {
-            status = ort->AllocatorFree(global_allocator, (void *)output_names[i]);
+        if (bind_outputs) {
+            for (size_t i = 0; i < n_output_nodes; i++) {
+                RAI_ExecutionCtx_SetOutput(ectxs[0], output_tensors[i], i);
+                ort->ReleaseValue(outputs[i]);
+            }
+            array_free(output_tensors);
+            array_free(outputs);
+            ort->ReleaseIoBinding(io_binding);
+            for (size_t i = 0; i < n_input_nodes; i++) {
+                ort->ReleaseValue(inputs[i]);
+            }
+            array_free(inputs);
+            return REDISMODULE_OK;
         }
-        array_free(output_names);
 
         for (size_t i = 0; i < n_output_nodes; i++) {
             if (n_batches > 1) {
@@ -622,6 +745,7 @@ int RAI_ModelRunORT(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *error
             }
             ort->ReleaseValue(outputs[i]);
         }
+        array_free(output_tensors);
         array_free(outputs);
         for (size_t i = 0; i < n_input_nodes; i++) {
             ort->ReleaseValue(inputs[i]);
@@ -635,14 +759,6 @@ error:
         RAI_SetError(error, RAI_EMODELRUN, ort->GetErrorMessage(status));
         ort->ReleaseStatus(status);
     }
-    for (uint32_t i = 0; i < array_len(input_names); i++) {
-        status = ort->AllocatorFree(global_allocator, (void *)input_names[i]);
-    }
-    array_free(input_names);
-    for (uint32_t i = 0; i < array_len(output_names); i++) {
-        status = ort->AllocatorFree(global_allocator, (void *)output_names[i]);
-    }
-    array_free(output_names);
     for (size_t i = 0; i < array_len(inputs); i++) {
         ort->ReleaseValue(inputs[i]);
     }
@@ -651,6 +767,13 @@ error:
         ort->ReleaseValue(outputs[i]);
     }
     array_free(outputs);
+    for (size_t i = 0; i < array_len(output_tensors); i++) {
+        RAI_TensorFree(output_tensors[i]);
+    }
+    array_free(output_tensors);
+    if (io_binding) {
+        ort->ReleaseIoBinding(io_binding);
+    }
     if (info) {
         ort->ReleaseTensorTypeAndShapeInfo(info);
     }
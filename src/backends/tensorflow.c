@@ -12,14 +12,29 @@
 #include "redis_ai_objects/model.h"
 #include "redis_ai_objects/tensor.h"
 
+#include "backends_api.h"
+
 #include "tensorflow/c/c_api.h"
 
+/**
+ * The graph of a TF model, along with the ports of its inputs and outputs (which
+ * are resolved once, when the model is created) and the options for its runs.
+ */
+typedef struct RAI_TFModel {
+    TF_Graph *graph;
+    TF_Input *inputs;
+    TF_Output *outputs;
+    // Serialized RunOptions proto, or NULL if the runs are not limited in time.
+    TF_Buffer *run_options;
+} RAI_TFModel;
+
 int RAI_InitBackendTF(int (*get_api_fn)(const char *, void *)) {
     get_api_fn("RedisModule_Alloc", ((void **)&RedisModule_Alloc));
     get_api_fn("RedisModule_Calloc", ((void **)&RedisModule_Calloc));
     get_api_fn("RedisModule_Free", ((void **)&RedisModule_Free));
     get_api_fn("RedisModule_Realloc", ((void **)&RedisModule_Realloc));
     get_api_fn("RedisModule_Strdup", ((void **)&RedisModule_Strdup));
+    get_api_fn("GetModelExecutionTimeout", ((void **)&RedisAI_GetModelExecutionTimeout));
 
     // Set min logging level to 3 (out of 5) - this is workaround since if TF is writing extensively
     // log messages that to stderr, it may cause the system to be stuck.
@@ -230,6 +245,39 @@ TF_Tensor *RAI_TFTensorFromTensors(RAI_Tensor **tensors, size_t count) {
     return out;
 }
 
+/**
+ * Create the RunOptions for the model's runs, so that TF cancels a run session that
+ * exceeds the MODEL_EXECUTION_TIMEOUT (the ops of the session check for cancellation
+ * cooperatively, and the run returns with DEADLINE_EXCEEDED).
+ */
+static TF_Buffer *_TFCreateRunOptions(long long timeout_ms) {
+    if (timeout_ms <= 0) {
+        return NULL;
+    }
+    // RunOptions.timeout_in_ms is field 2 (varint), followed by its value
+    // encoded as a varint.
+    uint8_t proto[11];
+    size_t len = 0;
+    proto[len++] = 0x10;
+    uint64_t val = timeout_ms;
+    do {
+        uint8_t byte = val & 0x7f;
+        val >>= 7;
+        proto[len++] = val ? (byte | 0x80) : byte;
+    } while (val);
+    return TF_NewBufferFromString(proto, len);
+}
+
+static void _TFModelFree(RAI_TFModel *tf_model) {
+    TF_DeleteGraph(tf_model->graph);
+    RedisModule_Free(tf_model->inputs);
+    RedisModule_Free(tf_model->outputs);
+    if (tf_model->run_options) {
+        TF_DeleteBuffer(tf_model->run_options);
+    }
+    RedisModule_Free(tf_model);
+}
+
 RAI_Model *RAI_ModelCreateTF(RAI_Backend backend, const char *devicestr, RAI_ModelOpts opts,
                              size_t ninputs, const char **inputs, size_t noutputs,
                              const char **outputs, const char *modeldef, size_t modellen,
@@ -249,6 +297,8 @@ RAI_Model *RAI_ModelCreateTF(RAI_Backend backend, const char *devicestr, RAI_Mod
     TF_SessionOptions *sessionOptions = NULL;
     TF_Status *sessionStatus = NULL;
     TF_Session *session = NULL;
+    TF_Input *input_ports = NULL;
+    TF_Output *output_ports = NULL;
 
     tfbuffer->length = modellen;
     tfbuffer->data = modeldef;
@@ -262,8 +312,13 @@ RAI_Model *RAI_ModelCreateTF(RAI_Backend backend, const char *devicestr, RAI_Mod
         return NULL;
     }
 
+    // Resolve the ports of the inputs and outputs once, rather than on every run.
+    input_ports = RedisModule_Calloc(ninputs, sizeof(*input_ports));
+    output_ports = RedisModule_Calloc(noutputs, sizeof(*output_ports));
+
     for (size_t i = 0; i < ninputs; ++i) {
         TF_Operation *oper = TF_GraphOperationByName(model, inputs[i]);
+        input_ports[i] = (TF_Input){.oper = oper, .index = 0};
         if (oper == NULL || strcmp(TF_OperationOpType(oper), "Placeholder") != 0) {
             size_t len = strlen(inputs[i]);
             char *msg = RedisModule_Calloc(60 + len, sizeof(*msg));
@@ -276,6 +331,7 @@ RAI_Model *RAI_ModelCreateTF(RAI_Backend backend, const char *devicestr, RAI_Mod
 
     for (size_t i = 0; i < noutputs; ++i) {
         TF_Operation *oper = TF_GraphOperationByName(model, outputs[i]);
+        output_ports[i] = (TF_Output){.oper = oper, .index = 0};
         if (oper == NULL) {
             size_t len = strlen(outputs[i]);
             char *msg = RedisModule_Calloc(60 + len, sizeof(*msg));
@@ -402,8 +458,14 @@ RAI_Model *RAI_ModelCreateTF(RAI_Backend backend, const char *devicestr, RAI_Mod
     char *buffer = RedisModule_Calloc(modellen, sizeof(*buffer));
     memcpy(buffer, modeldef, modellen);
 
+    RAI_TFModel *tf_model = RedisModule_Alloc(sizeof(*tf_model));
+    tf_model->graph = model;
+    tf_model->inputs = input_ports;
+    tf_model->outputs = output_ports;
+    tf_model->run_options = _TFCreateRunOptions(RedisAI_GetModelExecutionTimeout());
+
     RAI_Model *ret = RedisModule_Calloc(1, sizeof(*ret));
-    ret->model = model;
+    ret->model = tf_model;
     ret->session = session;
     ret->backend = backend;
     ret->devicestr = RedisModule_Strdup(devicestr);
@@ -420,6 +482,10 @@ RAI_Model *RAI_ModelCreateTF(RAI_Backend backend, const char *devicestr, RAI_Mod
 
 cleanup:
     TF_DeleteGraph(model);
+    if (input_ports)
+        RedisModule_Free(input_ports);
+    if (output_ports)
+        RedisModule_Free(output_ports);
     if (options)
         TF_DeleteImportGraphDefOptions(options);
     if (tfbuffer)
@@ -450,7 +516,7 @@ void RAI_ModelFreeTF(RAI_Model *model, RAI_Error *error) {
         return;
     }
 
-    TF_DeleteGraph(model->model);
+    _TFModelFree(model->model);
     model->model = NULL;
 
     RedisModule_Free(model->devicestr);
@@ -490,9 +556,6 @@ int RAI_ModelRunTF(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *error)
     size_t ninputs = RAI_ExecutionCtx_NumInputs(ectxs[0]);
     size_t noutputs = RAI_ExecutionCtx_NumOutputs(ectxs[0]);
 
-    TF_Input inputs[ninputs];
-    TF_Output outputs[noutputs];
-
     TF_Tensor *inputTensorsValues[ninputs];
     TF_Tensor *outputTensorsValues[noutputs];
 
@@ -510,7 +573,7 @@ int RAI_ModelRunTF(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *error)
         }
     }
 
-    void *tfGraph = RAI_ModelGetModel(model);
+    RAI_TFModel *tf_model = RAI_ModelGetModel(model);
     void *tfSession = RAI_ModelGetSession(model);
 
     for (size_t i = 0; i < ninputs; ++i) {
@@ -519,26 +582,12 @@ int RAI_ModelRunTF(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *error)
             batched_input_tensors[b] = RAI_ExecutionCtx_GetInput(ectxs[b], i);
         }
         inputTensorsValues[i] = RAI_TFTensorFromTensors(batched_input_tensors, nbatches);
-        TF_Input port;
-        port.oper = TF_GraphOperationByName(tfGraph, RAI_ModelGetInputName(model, i));
-        // this operation must exist in the graph (verified when creating the model)
-        RedisModule_Assert(port.oper);
-        port.index = 0;
-        inputs[i] = port;
-    }
-
-    for (size_t i = 0; i < noutputs; ++i) {
-        TF_Output port;
-        port.oper = TF_GraphOperationByName(tfGraph, RAI_ModelGetOutputName(model, i));
-        // this operation must exist in the graph (verified when creating the model)
-        RedisModule_Assert(port.oper);
-        port.index = 0;
-        outputs[i] = port;
     }
 
-    TF_SessionRun(tfSession, NULL /* run_options */, inputs, inputTensorsValues, ninputs, outputs,
-                  outputTensorsValues, noutputs, NULL /* target_opers */, 0 /* ntargets */,
-                  NULL /* run_Metadata */, status);
+    // The ports of the inputs and outputs were resolved when creating the model.
+    TF_SessionRun(tfSession, tf_model->run_options, tf_model->inputs, inputTensorsValues, ninputs,
+                  tf_model->outputs, outputTensorsValues, noutputs, NULL /* target_opers */,
+                  0 /* ntargets */, NULL /* run_Metadata */, status);
 
     bool delete_output = true;
     if (TF_GetCode(status) != TF_OK) {
@@ -605,7 +654,8 @@ int RAI_ModelSerializeTF(RAI_Model *model, char **buffer, size_t *len, RAI_Error
         TF_Buffer *tf_buffer = TF_NewBuffer();
         TF_Status *status = TF_NewStatus();
 
-        TF_GraphToGraphDef(model->model, tf_buffer, status);
+        RAI_TFModel *tf_model = model->model;
+        TF_GraphToGraphDef(tf_model->graph, tf_buffer, status);
 
         if (TF_GetCode(status) != TF_OK) {
             RAI_SetError(error, RAI_EMODELSERIALIZE, "ERR Error serializing TF model");
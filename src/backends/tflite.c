@@ -10,6 +10,7 @@
 #include "util/arr.h"
 #include "libtflite_c/tflite_c.h"
 #include "redis_ai_objects/tensor.h"
+#include "backends_api.h"
 
 int RAI_InitBackendTFLite(int (*get_api_fn)(const char *, void *)) {
     get_api_fn("RedisModule_Alloc", ((void **)&RedisModule_Alloc));
@@ -18,6 +19,9 @@ int RAI_InitBackendTFLite(int (*get_api_fn)(const char *, void *)) {
     get_api_fn("RedisModule_Realloc", ((void **)&RedisModule_Realloc));
     get_api_fn("RedisModule_Strdup", ((void **)&RedisModule_Strdup));
 
+    // Export RedisAI callbacks.
+    get_api_fn("GetModelSessionPoolSize", ((void **)&RedisAI_GetModelSessionPoolSize));
+
     return REDISMODULE_OK;
 }
 
@@ -45,12 +49,20 @@ RAI_Model *RAI_ModelCreateTFLite(RAI_Backend backend, const char *devicestr, RAI
         return NULL;
     }
 
+    // The model definition is kept for serialization, and TFLite uses the same buffer
+    // rather than a copy of its own.
+    char *buffer = RedisModule_Calloc(modellen, sizeof(*buffer));
+    memcpy(buffer, modeldef, modellen);
+
     char *error_descr = NULL;
-    void *model = tfliteLoadModel(modeldef, modellen, dl_device, deviceid, &error_descr);
+    void *model = tfliteLoadModel(buffer, modellen, dl_device, deviceid,
+                                  (size_t)RedisAI_GetModelSessionPoolSize(),
+                                  (int)opts.backends_intra_op_parallelism, &error_descr);
 
     if (model == NULL) {
         RAI_SetError(error, RAI_EMODELCREATE, error_descr);
         RedisModule_Free(error_descr);
+        RedisModule_Free(buffer);
         return NULL;
     }
 
@@ -84,9 +96,6 @@ RAI_Model *RAI_ModelCreateTFLite(RAI_Backend backend, const char *devicestr, RAI
         outputs_ = array_append(outputs_, RedisModule_Strdup(output));
     }
 
-    char *buffer = RedisModule_Calloc(modellen, sizeof(*buffer));
-    memcpy(buffer, modeldef, modellen);
-
     RAI_Model *ret = RedisModule_Calloc(1, sizeof(*ret));
     ret->model = model;
     ret->session = NULL;
@@ -119,13 +128,16 @@ cleanup:
         }
         array_free(outputs_);
     }
+    tfliteDeallocContext(model);
+    RedisModule_Free(buffer);
     return NULL;
 }
 
 void RAI_ModelFreeTFLite(RAI_Model *model, RAI_Error *error) {
+    // The TFLite model is built on top of the model data, so it is released first.
+    tfliteDeallocContext(model->model);
     RedisModule_Free(model->data);
     RedisModule_Free(model->devicestr);
-    tfliteDeallocContext(model->model);
     size_t ninputs = model->ninputs;
     for (size_t i = 0; i < ninputs; i++) {
         RedisModule_Free(model->inputs[i]);
@@ -160,8 +172,12 @@ int RAI_ModelRunTFLite(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *er
     size_t batch_sizes[nbatches];
     size_t batch_offsets[nbatches];
     size_t total_batch_size = 0;
+    RAI_Tensor **batch_buffers = NULL;
 
     if (nbatches > 1) {
+        // Inputs are written into the model's reusable batch tensors rather than into
+        // newly allocated ones.
+        batch_buffers = RAI_ModelAcquireBatchBuffers(model, ninputs);
         if (ninputs > 0) {
             for (size_t b = 0; b < nbatches; ++b) {
                 batch_sizes[b] = RAI_TensorDim(RAI_ExecutionCtx_GetInput(ectxs[b], 0), 0);
@@ -180,7 +196,7 @@ int RAI_ModelRunTFLite(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *er
                 batch[b] = RAI_ExecutionCtx_GetInput(ectxs[b], i);
             }
 
-            inputs[i] = RAI_TensorCreateByConcatenatingTensors(batch, nbatches);
+            inputs[i] = RAI_TensorConcatenateIntoBatch(&batch_buffers[i], batch, nbatches);
             inputs_dl[i] = &inputs[i]->tensor;
         }
     } else {
@@ -202,6 +218,9 @@ int RAI_ModelRunTFLite(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *er
     for (size_t i = 0; i < ninputs; ++i) {
         RAI_TensorFree(inputs[i]);
     }
+    if (batch_buffers) {
+        RAI_ModelReleaseBatchBuffers(model, batch_buffers);
+    }
 
     if (error_descr != NULL) {
         RAI_SetError(error, RAI_EMODELRUN, error_descr);
@@ -248,3 +267,7 @@ int RAI_ModelSerializeTFLite(RAI_Model *model, char **buffer, size_t *len, RAI_E
 }
 
 const char *RAI_GetBackendVersionTFLite(void) { return "NA"; }
+
+unsigned long long RAI_GetShapeCacheHitsTFLite(void) { return tfliteShapeCacheHits(); }
+
+unsigned long long RAI_GetShapeCacheMissesTFLite(void) { return tfliteShapeCacheMisses(); }
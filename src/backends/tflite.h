@@ -23,3 +23,7 @@ int RAI_ModelRunTFLite(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *er
 int RAI_ModelSerializeTFLite(RAI_Model *model, char **buffer, size_t *len, RAI_Error *error);
 
 const char *RAI_GetBackendVersionTFLite(void);
+
+unsigned long long RAI_GetShapeCacheHitsTFLite(void);
+
+unsigned long long RAI_GetShapeCacheMissesTFLite(void);
@@ -49,6 +49,8 @@ int RAI_InitBackendTorch(int (*get_api_fn)(const char *, void *)) {
     get_api_fn("RedisAI_TensorGetDLTensor", ((void **)&RedisAI_TensorGetDLTensor));
     get_api_fn("RedisAI_TensorGetShallowCopy", ((void **)&RedisAI_TensorGetShallowCopy));
     get_api_fn("RedisAI_TensorFree", ((void **)&RedisAI_TensorFree));
+    get_api_fn("RedisAI_TensorGetFromKeyspace", ((void **)&RedisAI_TensorGetFromKeyspace));
+    get_api_fn("RedisAI_TensorSetInKeyspace", ((void **)&RedisAI_TensorSetInKeyspace));
     get_api_fn("RedisAI_GetModelFromKeyspace", ((void **)&RedisAI_GetModelFromKeyspace));
     get_api_fn("RedisAI_ModelRunCtxCreate", ((void **)&RedisAI_ModelRunCtxCreate));
     get_api_fn("RedisAI_ModelRunCtxAddInput", ((void **)&RedisAI_ModelRunCtxAddInput));
@@ -221,8 +223,12 @@ int RAI_ModelRunTorch(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *err
     size_t batch_sizes[nbatches];
     size_t batch_offsets[nbatches];
     size_t total_batch_size = 0;
+    RAI_Tensor **batch_buffers = NULL;
 
     if (nbatches > 1) {
+        // Inputs are written into the model's reusable batch tensors rather than into
+        // newly allocated ones.
+        batch_buffers = RAI_ModelAcquireBatchBuffers(model, ninputs);
         if (ninputs > 0) {
             for (size_t b = 0; b < nbatches; ++b) {
                 batch_sizes[b] = RAI_TensorDim(RAI_ExecutionCtx_GetInput(ectxs[b], 0), 0);
@@ -241,7 +247,7 @@ int RAI_ModelRunTorch(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *err
                 batch[b] = RAI_ExecutionCtx_GetInput(ectxs[b], i);
             }
 
-            inputs[i] = RAI_TensorCreateByConcatenatingTensors(batch, nbatches);
+            inputs[i] = RAI_TensorConcatenateIntoBatch(&batch_buffers[i], batch, nbatches);
             inputs_dl[i] = &inputs[i]->tensor;
         }
     } else {
@@ -261,6 +267,9 @@ int RAI_ModelRunTorch(RAI_Model *model, RAI_ExecutionCtx **ectxs, RAI_Error *err
     for (size_t i = 0; i < ninputs; ++i) {
         RAI_TensorFree(inputs[i]);
     }
+    if (batch_buffers) {
+        RAI_ModelReleaseBatchBuffers(model, batch_buffers);
+    }
 
     if (error_descr != NULL) {
         RAI_SetError(error, RAI_EMODELRUN, error_descr);
@@ -473,3 +482,7 @@ int RAI_ScriptRunTorch(RAI_Script *script, const char *function, RAI_ExecutionCt
 }
 
 const char *RAI_GetBackendVersionTorch(void) { return "NA"; }
+
+unsigned long long RAI_GetOutputsCopiedTorch(void) { return torchOutputsCopied(); }
+
+unsigned long long RAI_GetOutputsCopiesSavedTorch(void) { return torchOutputsCopiesSaved(); }
@@ -33,3 +33,7 @@ int RAI_ScriptRunTorch(RAI_Script *script, const char *function, RAI_ExecutionCt
                        RAI_Error *error);
 
 const char *RAI_GetBackendVersionTorch(void);
+
+unsigned long long RAI_GetOutputsCopiedTorch(void);
+
+unsigned long long RAI_GetOutputsCopiesSavedTorch(void);
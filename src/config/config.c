@@ -6,6 +6,9 @@
 
 #include "config.h"
 #include <string.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/stat.h>
 #include "redismodule.h"
 #include "backends/backends.h"
 
@@ -24,6 +27,10 @@ long long ThreadPoolSizePerQueue = 1;
 long long ModelExecutionTimeout = 5000;
 // The maximum amount of memory in MB that backend is allowed to consume.
 long long BackendMemoryLimit = 0;
+// The maximum number of sessions per model. Default (0) is the number of threads per queue.
+long long ModelSessionPoolSize = 0;
+// Directory (canonical path) from which models can be loaded by path. Default is none.
+char *ModelRepository = NULL;
 
 static int _Config_LoadTimeParamParse(RedisModuleCtx *ctx, const char *key, const char *val,
                                       RedisModuleString *rsval) {
@@ -69,6 +76,17 @@ static int _Config_LoadTimeParamParse(RedisModuleCtx *ctx, const char *key, cons
         if (ret == REDISMODULE_OK) {
             RedisModule_Log(ctx, "notice", "%s: %s", REDISAI_INFOMSG_BACKEND_MEMORY_LIMIT, val);
         }
+    } else if (strcasecmp((key), "MODEL_SESSION_POOL_SIZE") == 0) {
+        ret = Config_SetModelSessionPoolSize(rsval);
+        if (ret == REDISMODULE_OK) {
+            RedisModule_Log(ctx, "notice", "%s: %s", REDISAI_INFOMSG_MODEL_SESSION_POOL_SIZE, val);
+        }
+    } else if (strcasecmp((key), "MODEL_REPOSITORY") == 0) {
+        ret = Config_SetModelRepository(val);
+        if (ret == REDISMODULE_OK) {
+            RedisModule_Log(ctx, "notice", "%s: %s", REDISAI_INFOMSG_MODEL_REPOSITORY,
+                            ModelRepository);
+        }
     } else if (strcasecmp((key), "BACKENDSPATH") == 0) {
         // already taken care of
     } else {
@@ -89,8 +107,14 @@ long long Config_GetModelExecutionTimeout() { return ModelExecutionTimeout; }
 
 long long Config_GetBackendMemoryLimit() { return BackendMemoryLimit; }
 
+long long Config_GetModelSessionPoolSize() {
+    return ModelSessionPoolSize > 0 ? ModelSessionPoolSize : ThreadPoolSizePerQueue;
+}
+
 char *Config_GetBackendsPath() { return BackendsPath; }
 
+const char *Config_GetModelRepository() { return ModelRepository; }
+
 int Config_LoadBackend(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     if (argc < 3)
         return RedisModule_WrongArity(ctx);
@@ -184,6 +208,29 @@ int Config_SetBackendMemoryLimit(RedisModuleString *memory_limit) {
     return REDISMODULE_OK;
 }
 
+int Config_SetModelSessionPoolSize(RedisModuleString *pool_size) {
+    long long val;
+    int result = RedisModule_StringToLongLong(pool_size, &val);
+    if (result != REDISMODULE_OK || val < 0) {
+        return REDISMODULE_ERR;
+    }
+    ModelSessionPoolSize = val;
+    return REDISMODULE_OK;
+}
+
+int Config_SetModelRepository(const char *path) {
+    char resolved[PATH_MAX];
+    struct stat st;
+    if (realpath(path, resolved) == NULL || stat(resolved, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        return REDISMODULE_ERR;
+    }
+    if (ModelRepository) {
+        RedisModule_Free(ModelRepository);
+    }
+    ModelRepository = RedisModule_Strdup(resolved);
+    return REDISMODULE_OK;
+}
+
 int Config_SetLoadTimeParams(RedisModuleCtx *ctx, RedisModuleString *const *argv, int argc) {
     if (argc > 0 && argc % 2 != 0) {
         RedisModule_Log(ctx, "warning",
@@ -33,6 +33,8 @@ typedef enum { RAI_DEVICE_CPU = 0, RAI_DEVICE_GPU = 1 } RAI_Device;
 #define REDISAI_INFOMSG_MODEL_CHUNK_SIZE        "Setting MODEL_CHUNK_SIZE parameter to"
 #define REDISAI_INFOMSG_MODEL_EXECUTION_TIMEOUT "Setting MODEL_EXECUTION_TIMEOUT parameter to"
 #define REDISAI_INFOMSG_BACKEND_MEMORY_LIMIT    "Setting BACKEND_MEMORY_LIMIT parameter to"
+#define REDISAI_INFOMSG_MODEL_SESSION_POOL_SIZE "Setting MODEL_SESSION_POOL_SIZE parameter to"
+#define REDISAI_INFOMSG_MODEL_REPOSITORY        "Setting MODEL_REPOSITORY parameter to"
 
 #define REDISAI_DEFAULT_MODEL_CHUNK_SIZE (511 * 1024 * 1024)
 
@@ -61,7 +63,7 @@ long long Config_GetNumThreadsPerQueue(void);
 
 /**
  * @return Number of milliseconds that a model session is allowed to run
- * before killing it. Currently supported only for onnxruntime backend.
+ * before killing it. Currently supported only for onnxruntime and tensorflow backends.
  */
 long long Config_GetModelExecutionTimeout(void);
 
@@ -72,11 +74,25 @@ long long Config_GetModelExecutionTimeout(void);
  */
 long long Config_GetBackendMemoryLimit(void);
 
+/**
+ * @return The maximum number of sessions (interpreters) that a backend may hold for a
+ * single model, so that the same model can be executed concurrently by several working
+ * threads. Unless configured explicitly, this equals the number of threads per queue.
+ * Currently supported only for tflite backend.
+ */
+long long Config_GetModelSessionPoolSize(void);
+
 /**
  * @return Returns the backends path string.
  */
 char *Config_GetBackendsPath(void);
 
+/**
+ * @return Returns the canonical path of the directory from which models can be
+ * loaded by path (AI.MODELSTORE ... PATH), or NULL if it was not configured.
+ */
+const char *Config_GetModelRepository(void);
+
 /**
  * Helper method for AI.CONFIG LOADBACKEND <backend_identifier>
  * <location_of_backend_library>
@@ -141,6 +157,22 @@ int Config_SetModelExecutionTimeout(RedisModuleString *timeout);
  */
 int Config_SetBackendMemoryLimit(RedisModuleString *memory_limit);
 
+/**
+ * Set the maximum number of sessions (interpreters) that a backend may hold per model.
+ * @param pool_size - string containing the pool size. If value is zero, the pool
+ * size follows the number of threads per queue.
+ * @return REDISMODULE_OK on success, or REDISMODULE_ERR  if failed
+ */
+int Config_SetModelSessionPoolSize(RedisModuleString *pool_size);
+
+/**
+ * Set the directory from which models can be loaded by path. Only files under this
+ * directory can be loaded, so it is configurable at load time only.
+ * @param path - path of an existing directory.
+ * @return REDISMODULE_OK on success, or REDISMODULE_ERR  if failed
+ */
+int Config_SetModelRepository(const char *path);
+
 /**
  * Load time configuration parser
  * @param ctx Context in which Redis modules operate
@@ -14,16 +14,18 @@
  * (when possible) is the following: instead of running the whole DAG in one
  * swoop, the DAG run info is created on one
  * queue/device and shallow copied (appropriately) across other queues/devices
- * as indicated by the DAG specification. A DAG mutex is shared across all
- * copies.
+ * as indicated by the DAG specification. Ops of the same device that don't
+ * depend on each other are given to different copies as well, so that they
+ * can run in parallel on different workers of the device (see
+ * DAG_InsertDAGToQueue). A DAG mutex is shared across all copies.
  * The DAG run info is placed on the queue for each device and evicted for
  * execution (in background_workers). Execution happens one DAG op at a time:
  * once the individual op has executed, it is marked as such and the DAG run
- * info is placed back on the queue. The current un-executed op is checked for
- * its inputs. If all inputs are found in the tensor context, then the DAG op
- * can be executed. If not, the execution quits and control is given back to
- * the worker. If there are other items in the queue the op is placed after the
- * next item. When all ops for a device have been executed, the DAG is not
+ * info is placed back on the queue, provided that all the inputs of its next op
+ * are found in the tensor context. If not, the run info waits outside of the
+ * queue until the copy that produces the last missing input pushes it back
+ * (see RedisAI_DagWaitForInputs), so a run info in the queue can always be
+ * executed. When all ops for a device have been executed, the DAG is not
  * placed back on the queue. When all ops in a DAG have been executed or an
  * error occurs, the client is unblocked.
  *
@@ -93,26 +95,6 @@ static void Dag_StoreCurrentOpOutputs(RedisAI_RunInfo *rinfo, RAI_DagOp *current
     RAI_ContextUnlock(rinfo);
 }
 
-static int _StoreTensorInKeySpace(RedisModuleCtx *ctx, RAI_Tensor *tensor,
-                                  RedisModuleString *persist_key_name, RAI_Error *err) {
-
-    RedisModuleKey *key;
-    int status =
-        RAI_TensorOpenKey(ctx, persist_key_name, &key, REDISMODULE_READ | REDISMODULE_WRITE, err);
-    if (status == REDISMODULE_ERR) {
-        return REDISMODULE_ERR;
-    }
-    if (RedisModule_ModuleTypeSetValue(key, RAI_TensorRedisType(), tensor) != REDISMODULE_OK) {
-        RAI_SetError(err, RAI_EDAGRUN, "ERR could not save tensor");
-        RedisModule_CloseKey(key);
-        return REDISMODULE_ERR;
-    }
-    // Only if we got until here, tensor is saved in keyspace.
-    RAI_TensorReplicate(ctx, persist_key_name, tensor);
-    RedisModule_CloseKey(key);
-    return REDISMODULE_OK;
-}
-
 static int _DAG_PersistTensors(RedisModuleCtx *ctx, RedisAI_RunInfo *rinfo) {
 
     AI_dictIterator *persist_iter = AI_dictGetSafeIterator(rinfo->persistTensors);
@@ -124,7 +106,7 @@ static int _DAG_PersistTensors(RedisModuleCtx *ctx, RedisAI_RunInfo *rinfo) {
         RAI_Tensor *tensor = Dag_GetTensorFromGlobalCtx(rinfo, index);
         tensor = RAI_TensorGetShallowCopy(tensor);
 
-        if (_StoreTensorInKeySpace(ctx, tensor, persist_key_name, rinfo->err) == REDISMODULE_ERR) {
+        if (RAI_TensorSetInKeyspace(ctx, persist_key_name, tensor, rinfo->err) == REDISMODULE_ERR) {
             *rinfo->dagError = 1;
             RedisModule_Log(ctx, "warning",
                             "Could not persist tensor under the key (%s) after executing DAGRUN "
@@ -149,7 +131,7 @@ static int _Dag_SingleOpPersistTensors(RedisModuleCtx *ctx, RAI_DagOp *op, RAI_E
         if (!tensor)
             continue;
 
-        if (_StoreTensorInKeySpace(ctx, tensor, persist_key_name, err) == REDISMODULE_ERR) {
+        if (RAI_TensorSetInKeyspace(ctx, persist_key_name, tensor, err) == REDISMODULE_ERR) {
             RedisModule_Log(ctx, "warning",
                             "Could not persist tensor under the key (%s) after executing DAGRUN "
                             "command, persist stopped",
@@ -161,6 +143,35 @@ static int _Dag_SingleOpPersistTensors(RedisModuleCtx *ctx, RAI_DagOp *op, RAI_E
     return REDISMODULE_OK;
 }
 
+/**
+ * Returns the time that passed from the last time the run info entered its run queue
+ * (that is, when its current op became ready) until start (in microseconds). This
+ * excludes the execution of the DAG's previous ops.
+ */
+static long long _DAG_QueueWaitTime(RedisAI_RunInfo *rinfo, long long start) {
+    return start > rinfo->queueEnterTime ? start - rinfo->queueEnterTime : 0;
+}
+
+/**
+ * Record the execution time of a (possibly batched) model run in the model's
+ * adaptive batching profile, where the batch size is the total size of the first
+ * input along the 0-th dimension.
+ */
+static void _DAG_RecordBatchingRun(RAI_Model *model, RAI_ExecutionCtx **ectxs, int n_ectxs,
+                                   long long duration_us) {
+    if (!model->batching) {
+        return;
+    }
+    size_t batchsize = 0;
+    for (int i = 0; i < n_ectxs; i++) {
+        if (RAI_ExecutionCtx_NumInputs(ectxs[i]) == 0) {
+            return;
+        }
+        batchsize += RAI_TensorDim(RAI_ExecutionCtx_GetInput(ectxs[i], 0), 0);
+    }
+    RAI_BatchingProfileAddRun(model->batching, batchsize, duration_us);
+}
+
 /**
  * Execution of a MODELRUN DAG step.
  * If an error occurs, it is recorded in the DagOp struct.
@@ -184,9 +195,11 @@ void RedisAI_DagRunSession_ModelRun_Step(RedisAI_RunInfo *rinfo, RAI_DagOp *curr
     const long long end = ustime();
 
     currentOp->duration_us = end - start;
+    currentOp->queue_wait_us = _DAG_QueueWaitTime(rinfo, start);
     currentOp->result = result;
     if (result == REDISMODULE_ERR)
         return;
+    _DAG_RecordBatchingRun(model, ectxs, 1, currentOp->duration_us);
     if (rinfo->single_op_dag == 0)
         Dag_StoreCurrentOpOutputs(rinfo, currentOp);
 }
@@ -222,11 +235,16 @@ void RedisAI_BatchedDagRunSession_ModelRun_Step(RedisAI_RunInfo **batched_rinfo,
     const long long end = ustime();
 
     long long duration = end - start;
+    if (result == REDISMODULE_OK) {
+        RAI_Model *model = RAI_ModelRunCtxGetModel((RAI_ModelRunCtx *)ectxs[0]);
+        _DAG_RecordBatchingRun(model, ectxs, n_rinfo, duration);
+    }
 
     for (int i = 0; i < n_rinfo; i++) {
         RedisAI_RunInfo *rinfo = batched_rinfo[i];
         RAI_DagOp *currentOp = currentOps[i];
         currentOp->duration_us = duration;
+        currentOp->queue_wait_us = _DAG_QueueWaitTime(rinfo, start);
         currentOp->result = result;
 
         if (result == REDISMODULE_ERR) {
@@ -250,25 +268,8 @@ void RedisAI_BatchedDagRunSession_ModelRun_Step(RedisAI_RunInfo **batched_rinfo,
  * @return
  */
 void RedisAI_DagRunSession_ScriptRun_Step(RedisAI_RunInfo *rinfo, RAI_DagOp *currentOp) {
-    uint n_inkeys = array_len(currentOp->inkeys);
-    uint n_outkeys = array_len(currentOp->outkeys);
-
-    if (!rinfo->single_op_dag) {
-        RAI_ContextReadLock(rinfo);
-        RAI_Tensor *inputTensors[n_inkeys];
-        for (uint i = 0; i < n_inkeys; i++) {
-            RAI_Tensor *inputTensor =
-                Dag_GetTensorFromGlobalCtx(rinfo, currentOp->inkeys_indices[i]);
-            inputTensors[i] = inputTensor;
-        }
-        RAI_ContextUnlock(rinfo);
-        for (uint i = 0; i < n_inkeys; i++) {
-            RAI_ExecutionCtx_AddInput(currentOp->ectx, inputTensors[i]);
-        }
-        for (uint i = 0; i < n_outkeys; i++) {
-            RAI_ExecutionCtx_AddOutputPlaceholder(currentOp->ectx);
-        }
-    }
+    if (!rinfo->single_op_dag)
+        Dag_LoadInputsToCurrentOp(rinfo, currentOp);
 
     const long long start = ustime();
     int result = RAI_ScriptRun((RAI_ScriptRunCtx *)currentOp->ectx, currentOp->err);
@@ -276,23 +277,81 @@ void RedisAI_DagRunSession_ScriptRun_Step(RedisAI_RunInfo *rinfo, RAI_DagOp *cur
 
     currentOp->result = result;
     currentOp->duration_us = end - start;
+    currentOp->queue_wait_us = _DAG_QueueWaitTime(rinfo, start);
     if (result != REDISMODULE_OK) {
         return;
     }
 
-    if (!rinfo->single_op_dag) {
-        RAI_ContextWriteLock(rinfo);
-        const size_t noutputs = RAI_ExecutionCtx_NumOutputs(currentOp->ectx);
-        for (size_t outputNumber = 0; outputNumber < noutputs; outputNumber++) {
-            RAI_Tensor *tensor = RAI_ExecutionCtx_GetOutput(currentOp->ectx, outputNumber);
-            Dag_SetTensorInGlobalCtx(rinfo, currentOp->outkeys_indices[outputNumber], tensor);
+    if (!rinfo->single_op_dag)
+        Dag_StoreCurrentOpOutputs(rinfo, currentOp);
+}
+
+/**
+ * Execution of a batched SCRIPTRUN DAG step, where all the ops call the same
+ * batched entry point of the same script.
+ * If an error occurs, it is recorded in all DagOp structs.
+ *
+ * @param batched_rinfo array of contexts in which RedisAI blocking commands operate.
+ * @param currentOps SCRIPTRUN DagOps to be executed
+ * @return
+ */
+void RedisAI_BatchedDagRunSession_ScriptRun_Step(RedisAI_RunInfo **batched_rinfo,
+                                                 RAI_DagOp **currentOps) {
+
+    int n_rinfo = array_len(batched_rinfo);
+    RAI_ScriptRunCtx *sctxs[n_rinfo];
+
+    for (int i = 0; i < n_rinfo; i++) {
+        RedisAI_RunInfo *rinfo = batched_rinfo[i];
+        RAI_DagOp *currentOp = currentOps[i];
+        if (rinfo->single_op_dag == 0)
+            Dag_LoadInputsToCurrentOp(rinfo, currentOp);
+        sctxs[i] = (RAI_ScriptRunCtx *)currentOp->ectx;
+    }
+
+    RAI_Error err = {0};
+    const long long start = ustime();
+    int result = RAI_ScriptRunBatched(sctxs, n_rinfo, &err);
+    const long long end = ustime();
+
+    long long duration = end - start;
+    for (int i = 0; i < n_rinfo; i++) {
+        RedisAI_RunInfo *rinfo = batched_rinfo[i];
+        RAI_DagOp *currentOp = currentOps[i];
+        currentOp->duration_us = duration;
+        currentOp->queue_wait_us = _DAG_QueueWaitTime(rinfo, start);
+        currentOp->result = result;
+
+        if (result == REDISMODULE_ERR) {
+            RAI_SetError(currentOp->err, err.code, err.detail);
+            continue;
         }
-        RAI_ContextUnlock(rinfo);
+        if (rinfo->single_op_dag == 0)
+            Dag_StoreCurrentOpOutputs(rinfo, currentOp);
     }
+    // Clear the result in case of an error.
+    if (result == REDISMODULE_ERR)
+        RAI_ClearError(&err);
+}
+
+/**
+ * Appends a string to a batching signature, packed into long long words and
+ * preceded by its length.
+ */
+static long long *_DAG_SignatureAppendString(long long *signature, const char *str, size_t len) {
+    signature = array_append(signature, (long long)len);
+    for (size_t i = 0; i < len; i += sizeof(long long)) {
+        long long word = 0;
+        size_t n = len - i < sizeof(long long) ? len - i : sizeof(long long);
+        memcpy(&word, str + i, n);
+        signature = array_append(signature, word);
+    }
+    return signature;
 }
 
 size_t RAI_DagOpBatchSize(RAI_DagOp *op, RedisAI_RunInfo *rinfo) {
-    if (op->commandType != REDISAI_DAG_CMD_MODELRUN) {
+    if (op->commandType != REDISAI_DAG_CMD_MODELRUN &&
+        op->commandType != REDISAI_DAG_CMD_SCRIPTRUN) {
         return -1;
     }
 
@@ -308,6 +367,11 @@ size_t RAI_DagOpBatchSize(RAI_DagOp *op, RedisAI_RunInfo *rinfo) {
             input = Dag_GetTensorFromGlobalCtx(rinfo, op->inkeys_indices[i]);
         }
 
+        // A scalar input has no batch dimension, so the op can't be batched.
+        if (RAI_TensorNumDims(input) == 0) {
+            batchsize = 0;
+            break;
+        }
         if (i == 0) {
             batchsize = RAI_TensorDim(input, 0);
             continue;
@@ -322,58 +386,57 @@ size_t RAI_DagOpBatchSize(RAI_DagOp *op, RedisAI_RunInfo *rinfo) {
     return batchsize;
 }
 
-bool RAI_DagOpBatchable(RAI_DagOp *op1, RedisAI_RunInfo *rinfo1, RAI_DagOp *op2,
-                        RedisAI_RunInfo *rinfo2) {
-
-    RedisModule_Assert(op1->commandType == REDISAI_DAG_CMD_MODELRUN &&
-                       op2->commandType == REDISAI_DAG_CMD_MODELRUN);
-    RAI_ExecutionCtx *ectx1 = op1->ectx;
-    RAI_ExecutionCtx *ectx2 = op2->ectx;
-    if (RAI_ModelRunCtxGetModel((RAI_ModelRunCtx *)ectx1) !=
-        RAI_ModelRunCtxGetModel((RAI_ModelRunCtx *)ectx2)) {
-        return false;
-    }
-    const int ninputs1 = array_len(op1->inkeys);
-    const int ninputs2 = array_len(op2->inkeys);
-    if (ninputs1 != ninputs2) {
-        return false;
+long long *RedisAI_DagOpBatchingSignature(RedisAI_RunInfo *rinfo, RAI_DagOp *op) {
+    RAI_ExecutionCtx *ectx = op->ectx;
+    const size_t ninputs = array_len(op->inkeys);
+
+    long long *signature = array_new(long long, 2 + 7 * ninputs);
+    if (op->commandType == REDISAI_DAG_CMD_SCRIPTRUN) {
+        // Script runs are batched only if they call the same function with the same
+        // keys and args, and expect the same number of outputs.
+        RAI_ScriptRunCtx *sctx = (RAI_ScriptRunCtx *)ectx;
+        signature = array_append(signature, (long long)(intptr_t)sctx->script);
+        signature = _DAG_SignatureAppendString(signature, sctx->fnname, strlen(sctx->fnname));
+        signature = array_append(signature, (long long)array_len(op->outkeys));
+        RedisModuleString **strs[] = {sctx->keys, sctx->args};
+        for (size_t k = 0; k < 2; k++) {
+            signature = array_append(signature, (long long)array_len(strs[k]));
+            for (size_t i = 0; i < array_len(strs[k]); i++) {
+                size_t len;
+                const char *str = RedisModule_StringPtrLen(strs[k][i], &len);
+                signature = _DAG_SignatureAppendString(signature, str, len);
+            }
+        }
+    } else {
+        RedisModule_Assert(op->commandType == REDISAI_DAG_CMD_MODELRUN);
+        signature = array_append(
+            signature, (long long)(intptr_t)RAI_ModelRunCtxGetModel((RAI_ModelRunCtx *)ectx));
     }
+    signature = array_append(signature, (long long)ninputs);
 
-    RAI_ContextReadLock(rinfo1);
-    RAI_ContextReadLock(rinfo2);
-    for (int i = 0; i < ninputs1; i++) {
-        RAI_Tensor *input1;
-        if (rinfo1->single_op_dag) {
-            input1 = RAI_ExecutionCtx_GetInput(ectx1, i);
-        } else {
-            input1 = Dag_GetTensorFromGlobalCtx(rinfo1, op1->inkeys_indices[i]);
-        }
-        RAI_Tensor *input2;
-        if (rinfo2->single_op_dag) {
-            input2 = RAI_ExecutionCtx_GetInput(ectx2, i);
+    RAI_ContextReadLock(rinfo);
+    for (size_t i = 0; i < ninputs; i++) {
+        RAI_Tensor *input;
+        if (rinfo->single_op_dag) {
+            input = RAI_ExecutionCtx_GetInput(ectx, i);
         } else {
-            input2 = Dag_GetTensorFromGlobalCtx(rinfo2, op2->inkeys_indices[i]);
-        }
-        int ndims1 = RAI_TensorNumDims(input1);
-        int ndims2 = RAI_TensorNumDims(input2);
-        if (ndims1 != ndims2) {
-            return false;
-        }
-        if (ndims1 == 0) {
-            continue;
+            input = Dag_GetTensorFromGlobalCtx(rinfo, op->inkeys_indices[i]);
         }
-        for (int j = 1; j < ndims1; j++) {
-            long long dim1 = RAI_TensorDim(input1, j);
-            long long dim2 = RAI_TensorDim(input2, j);
-            if (dim1 != dim2) {
-                return false;
-            }
+        // Inputs of different types cannot be concatenated into a single batch.
+        DLDataType dtype = RAI_TensorDataType(input);
+        signature = array_append(signature, dtype.code);
+        signature = array_append(signature, dtype.bits);
+        signature = array_append(signature, dtype.lanes);
+        int ndims = RAI_TensorNumDims(input);
+        signature = array_append(signature, ndims);
+        // The 0-th dimension is the batch dimension, so it is not a part of the signature.
+        for (int j = 1; j < ndims; j++) {
+            signature = array_append(signature, RAI_TensorDim(input, j));
         }
     }
-    RAI_ContextUnlock(rinfo1);
-    RAI_ContextUnlock(rinfo2);
+    RAI_ContextUnlock(rinfo);
 
-    return true;
+    return signature;
 }
 
 bool RedisAI_DagDeviceComplete(RedisAI_RunInfo *rinfo) {
@@ -391,7 +454,7 @@ bool RedisAI_DagError(RedisAI_RunInfo *rinfo) {
 }
 
 bool RedisAI_DagTimeout(RedisAI_RunInfo *rinfo) {
-    __atomic_load_n(rinfo->timedOut, __ATOMIC_RELAXED) != 0;
+    return __atomic_load_n(rinfo->timedOut, __ATOMIC_RELAXED) != 0;
 }
 
 void RedisAI_DagSetTimeout(RedisAI_RunInfo *rinfo) {
@@ -406,38 +469,76 @@ RAI_DagOp *RedisAI_DagCurrentOp(RedisAI_RunInfo *rinfo) {
     return rinfo->dagDeviceOps[rinfo->dagDeviceCompleteOpCount];
 }
 
-void RedisAI_DagCurrentOpInfo(RedisAI_RunInfo *rinfo, bool *currentOpReady,
-                              bool *currentOpBatchable) {
-
+bool RedisAI_DagCurrentOpBatchable(RedisAI_RunInfo *rinfo) {
     RAI_DagOp *currentOp = RedisAI_DagCurrentOp(rinfo);
-    *currentOpReady = false;
-    *currentOpBatchable = false;
     RedisModule_Assert(currentOp);
-    if (currentOp->commandType == REDISAI_DAG_CMD_MODELRUN) {
-        RAI_ModelRunCtx *mctx = (RAI_ModelRunCtx *)currentOp->ectx;
-        RAI_Model *model = RAI_ModelRunCtxGetModel(mctx);
-        // TODO: Remove abstraction break
-        if (model->opts.batchsize > 0) {
-            *currentOpBatchable = true;
-        }
+    if (currentOp->commandType == REDISAI_DAG_CMD_SCRIPTRUN) {
+        RAI_ScriptRunCtx *sctx = (RAI_ScriptRunCtx *)currentOp->ectx;
+        return RAI_ScriptGetBatchOpts(sctx->script, sctx->fnname) != NULL;
     }
+    if (currentOp->commandType != REDISAI_DAG_CMD_MODELRUN) {
+        return false;
+    }
+    RAI_ModelRunCtx *mctx = (RAI_ModelRunCtx *)currentOp->ectx;
+    RAI_Model *model = RAI_ModelRunCtxGetModel(mctx);
+    // TODO: Remove abstraction break
+    return model->opts.batchsize > 0;
+}
 
-    *currentOpReady = true;
-    // If this is a single op dag, the op is definitely ready.
-    if (rinfo->single_op_dag)
-        return;
-
+/**
+ * Returns true if all the inputs of the copy's current op are available in the
+ * tensor context. Must be called while holding the DAG lock.
+ */
+static bool _DAG_CurrentOpReady(RedisAI_RunInfo *rinfo) {
+    RAI_DagOp *currentOp = RedisAI_DagCurrentOp(rinfo);
     uint n_inkeys = array_len(currentOp->inkeys);
-    RAI_ContextReadLock(rinfo);
-
-    for (int i = 0; i < n_inkeys; i++) {
+    for (uint i = 0; i < n_inkeys; i++) {
         if (Dag_GetTensorFromGlobalCtx(rinfo, currentOp->inkeys_indices[i]) == NULL) {
-            RAI_ContextUnlock(rinfo);
-            *currentOpReady = false;
-            return;
+            return false;
         }
     }
+    return true;
+}
+
+bool RedisAI_DagWaitForInputs(RedisAI_RunInfo *rinfo) {
+    // The ops of a single chain DAG are executed in order by a single copy, so the
+    // inputs of the current op were already produced.
+    if (rinfo->single_op_dag || rinfo->single_chain_dag) {
+        return false;
+    }
+    RedisAI_RunInfo *orig = rinfo->orig_copy;
+    bool wait = false;
+    RAI_ContextWriteLock(rinfo);
+    // If the DAG has failed, its waiting copies are released by the worker that
+    // handles the failure (see RedisAI_DagTakeReadyCopies), so don't wait anymore.
+    if (!RedisAI_DagError(rinfo) && !RedisAI_DagTimeout(rinfo) && !_DAG_CurrentOpReady(rinfo)) {
+        orig->dagWaitingCopies = array_append(orig->dagWaitingCopies, rinfo);
+        wait = true;
+    }
     RAI_ContextUnlock(rinfo);
+    return wait;
+}
+
+RedisAI_RunInfo **RedisAI_DagTakeReadyCopies(RedisAI_RunInfo *rinfo, RedisAI_RunInfo **ready) {
+    if (rinfo->single_op_dag || rinfo->single_chain_dag) {
+        return ready;
+    }
+    RedisAI_RunInfo *orig = rinfo->orig_copy;
+    RAI_ContextWriteLock(rinfo);
+    for (size_t i = 0; i < array_len(orig->dagReadyCopies); i++) {
+        ready = array_append(ready, orig->dagReadyCopies[i]);
+    }
+    array_clear(orig->dagReadyCopies);
+    // Once the DAG has failed, the waiting copies will never become ready, but
+    // they should still be finished by their device's workers.
+    if (RedisAI_DagError(rinfo) || RedisAI_DagTimeout(rinfo)) {
+        for (size_t i = 0; i < array_len(orig->dagWaitingCopies); i++) {
+            ready = array_append(ready, orig->dagWaitingCopies[i]);
+        }
+        array_clear(orig->dagWaitingCopies);
+    }
+    RAI_ContextUnlock(rinfo);
+    return ready;
 }
 
 void RedisAI_DagOpBatchInfo(RedisAI_RunInfo *rinfo, RAI_DagOp *op, size_t *batchsize,
@@ -446,6 +547,17 @@ void RedisAI_DagOpBatchInfo(RedisAI_RunInfo *rinfo, RAI_DagOp *op, size_t *batch
     *minbatchsize = 0;
     *minbatchtimeout = 0;
     *inbatchsize = 0;
+    if (op->commandType == REDISAI_DAG_CMD_SCRIPTRUN) {
+        RAI_ScriptRunCtx *sctx = (RAI_ScriptRunCtx *)op->ectx;
+        const RAI_ScriptBatchOpts *opts = RAI_ScriptGetBatchOpts(sctx->script, sctx->fnname);
+        if (!opts)
+            return;
+        *batchsize = opts->batchsize;
+        *minbatchsize = opts->minbatchsize;
+        *minbatchtimeout = opts->minbatchtimeout;
+        *inbatchsize = RAI_DagOpBatchSize(op, rinfo);
+        return;
+    }
     if (op->commandType != REDISAI_DAG_CMD_MODELRUN)
         return;
     RAI_ModelRunCtx *mctx = (RAI_ModelRunCtx *)op->ectx;
@@ -458,18 +570,11 @@ void RedisAI_DagOpBatchInfo(RedisAI_RunInfo *rinfo, RAI_DagOp *op, size_t *batch
     *inbatchsize = RAI_DagOpBatchSize(op, rinfo);
 }
 
-void RedisAI_DagOpBatchingMatch(RedisAI_RunInfo *rinfo1, RAI_DagOp *op1, RedisAI_RunInfo *rinfo2,
-                                RAI_DagOp *op2, int *batched, size_t *inbatchsize) {
-    *batched = 0;
-    *inbatchsize = 0;
-
-    if (op2->commandType == REDISAI_DAG_CMD_MODELRUN) {
-        bool match = RAI_DagOpBatchable(op1, rinfo1, op2, rinfo2);
-        if (match) {
-            *batched = 1;
-            *inbatchsize = RAI_DagOpBatchSize(op2, rinfo2);
-        }
-    }
+RAI_BatchingProfile *RedisAI_DagOpBatchingProfile(RAI_DagOp *op) {
+    if (op->commandType != REDISAI_DAG_CMD_MODELRUN)
+        return NULL;
+    RAI_Model *model = RAI_ModelRunCtxGetModel((RAI_ModelRunCtx *)op->ectx);
+    return model->batching;
 }
 
 RAI_Tensor *Dag_GetTensorFromGlobalCtx(RedisAI_RunInfo *rinfo, size_t index) {
@@ -481,6 +586,22 @@ void Dag_SetTensorInGlobalCtx(RedisAI_RunInfo *rinfo, size_t index, RAI_Tensor *
     RedisModule_Assert(index < array_len(rinfo->dagSharedTensors));
     RedisModule_Assert(rinfo->dagSharedTensors[index] == NULL);
     rinfo->dagSharedTensors[index] = RAI_TensorGetShallowCopy(t);
+
+    // Notify the copies that wait for this tensor: those whose current op has all
+    // of its inputs now are moved to the ready copies, to be pushed to their run
+    // queues by the worker that produced the tensor.
+    RedisAI_RunInfo *orig = rinfo->orig_copy;
+    size_t n_waiting = array_len(orig->dagWaitingCopies);
+    for (size_t i = 0; i < n_waiting;) {
+        RedisAI_RunInfo *waiting = orig->dagWaitingCopies[i];
+        if (!_DAG_CurrentOpReady(waiting)) {
+            i++;
+            continue;
+        }
+        orig->dagReadyCopies = array_append(orig->dagReadyCopies, waiting);
+        orig->dagWaitingCopies[i] = orig->dagWaitingCopies[--n_waiting];
+        array_pop(orig->dagWaitingCopies);
+    }
 }
 
 void RedisAI_DagRunSessionStep(RedisAI_RunInfo *rinfo, const char *devicestr) {
@@ -509,7 +630,8 @@ void RedisAI_DagRunSessionStep(RedisAI_RunInfo *rinfo, const char *devicestr) {
 }
 
 void RedisAI_BatchedDagRunSessionStep(RedisAI_RunInfo **batched_rinfo, const char *devicestr) {
-    // Assumption: ops are guaranteed to be all MODELRUN
+    // Assumption: ops are guaranteed to be all MODELRUN or all SCRIPTRUN, since they
+    // share the same batching signature.
 
     int n_ops = array_len(batched_rinfo);
     assert(n_ops > 1);
@@ -521,7 +643,11 @@ void RedisAI_BatchedDagRunSessionStep(RedisAI_RunInfo **batched_rinfo, const cha
         currentOps[i] = currentOp;
     }
 
-    RedisAI_BatchedDagRunSession_ModelRun_Step(batched_rinfo, currentOps);
+    if (RedisAI_DagCurrentOp(batched_rinfo[0])->commandType == REDISAI_DAG_CMD_SCRIPTRUN) {
+        RedisAI_BatchedDagRunSession_ScriptRun_Step(batched_rinfo, currentOps);
+    } else {
+        RedisAI_BatchedDagRunSession_ModelRun_Step(batched_rinfo, currentOps);
+    }
 
     for (int i = 0; i < n_ops; i++) {
         RedisAI_RunInfo *rinfo = batched_rinfo[i];
@@ -69,16 +69,33 @@ void RedisAI_DagSetTimeout(RedisAI_RunInfo *rinfo);
 RAI_DagOp *RedisAI_DagCurrentOp(RedisAI_RunInfo *rinfo);
 
 /**
- * Get information about current DAG op for the given device.
+ * Get whether the current DAG op for the given device is amenable to batching,
+ * that is, is it a MODELRUN and is BATCHSIZE greater than zero.
  * @param rinfo context in which RedisAI blocking commands operate.
- * @param currentOpReady have all inputs for the op been computed, that is,
- *            are they available in the tensor context
- * @param currentOpBatchable is the op amenable to batching, that is, is it
- *            a MODELRUN and is BATCHSIZE greater than zero
- * @return
+ * @return true if the current op is batchable
+ */
+bool RedisAI_DagCurrentOpBatchable(RedisAI_RunInfo *rinfo);
+
+/**
+ * If some inputs of the current DAG op for the given copy were not computed yet,
+ * register the copy as waiting for them. Once the last of these inputs is set in
+ * the tensor context (see Dag_SetTensorInGlobalCtx), the copy becomes ready and it
+ * is returned by RedisAI_DagTakeReadyCopies.
+ * @param rinfo context in which RedisAI blocking commands operate.
+ * @return true if the copy waits for its inputs, and false if its current op is
+ *            ready (or the DAG has failed) so it can be pushed to its run queue.
  */
-void RedisAI_DagCurrentOpInfo(RedisAI_RunInfo *rinfo, bool *currentOpReady,
-                              bool *currentOpBatchable);
+bool RedisAI_DagWaitForInputs(RedisAI_RunInfo *rinfo);
+
+/**
+ * Take the copies of the DAG that became ready since the last call, so they can be
+ * pushed to their run queues. If the DAG has failed or timed out, all the copies
+ * that wait for their inputs are taken as well.
+ * @param rinfo context in which RedisAI blocking commands operate.
+ * @param ready array (util/arr.h) to which the copies are appended.
+ * @return the (possibly reallocated) ready array.
+ */
+RedisAI_RunInfo **RedisAI_DagTakeReadyCopies(RedisAI_RunInfo *rinfo, RedisAI_RunInfo **ready);
 
 /**
  * Get batching information about a DAG op.
@@ -95,17 +112,34 @@ void RedisAI_DagOpBatchInfo(RedisAI_RunInfo *rinfo, RAI_DagOp *op, size_t *batch
                             size_t *minbatchsize, size_t *minbatchtimeout, size_t *inbatchsize);
 
 /**
- * Check that a DAG operation can be batched with a given batch operation.
- * @param rinfo1 given context in which RedisAI blocking commands operate.
- * @param op1 given DAG operation
- * @param rinfo2 other context in which RedisAI blocking commands operate.
- * @param op2 other DAG operation to be checked
- * @param batched can op2 be batched with op1
- * @param inbatchsize actual size of the batch in op2
- * @return
+ * Get the adaptive batching profile of the model that a DAG op runs.
+ * @param op DAG operation
+ * @return the profile, or NULL if the op is not a MODELRUN of a model that was
+ *            stored with LATENCYTARGET.
+ */
+RAI_BatchingProfile *RedisAI_DagOpBatchingProfile(RAI_DagOp *op);
+
+/**
+ * Get the actual size of the batch in a (MODELRUN) DAG operation, that is, the
+ * size of its input tensors along the zero-th dimension.
+ * @param op DAG operation
+ * @param rinfo context in which RedisAI blocking commands operate.
+ * @return the batch size, or 0 if the inputs sizes along the zero-th dimension
+ *            don't match
+ */
+size_t RAI_DagOpBatchSize(RAI_DagOp *op, RedisAI_RunInfo *rinfo);
+
+/**
+ * Get the batching signature of a (MODELRUN or SCRIPTRUN) DAG operation whose
+ * inputs are ready. Two operations can be batched together if and only if their
+ * signatures are equal, that is, if they run the same model (or script function)
+ * and their inputs have the same types and shapes, except for the zero-th
+ * (batch) dimension.
+ * @param rinfo context in which RedisAI blocking commands operate.
+ * @param op DAG operation
+ * @return a newly allocated array (util/arr.h) that the caller should free.
  */
-void RedisAI_DagOpBatchingMatch(RedisAI_RunInfo *rinfo1, RAI_DagOp *op1, RedisAI_RunInfo *rinfo2,
-                                RAI_DagOp *op2, int *batched, size_t *inbatchsize);
+long long *RedisAI_DagOpBatchingSignature(RedisAI_RunInfo *rinfo, RAI_DagOp *op);
 
 /**
  * @brief Get a tensor from the dag local context in a given index
@@ -118,7 +152,8 @@ RAI_Tensor *Dag_GetTensorFromGlobalCtx(RedisAI_RunInfo *rinfo, size_t index);
 
 /**
  * @brief Shallow copy and set a tensor in the dag local context in a given index.
- * (this access to a shared array, require write lock)
+ * (this access to a shared array, require write lock). The DAG copies that wait
+ * for this tensor, and have all of their current op's inputs now, become ready.
  * @param rinfo The DAG runInfo.
  * @param index The index to put in the given tensor in the Dag shared array.
  * @param t The tensor to shallow copy and store in the given index.
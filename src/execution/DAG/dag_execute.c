@@ -10,6 +10,7 @@
 #include "util/string_utils.h"
 #include "execution/run_info.h"
 #include "execution/background_workers.h"
+#include "execution/DAG/dag.h"
 
 int ValidatePersistKeys(RedisAI_RunInfo *rinfo, AI_dict *tensorsNamesToInd,
                         AI_dict *persistTensorsNames) {
@@ -68,6 +69,115 @@ int MapTensorsKeysToIndices(RedisAI_RunInfo *rinfo, AI_dict *tensorsNamesToInd)
     return REDISMODULE_OK;
 }
 
+static bool _DAG_IsLightOp(RAI_DagOp *op) {
+    return op->commandType == REDISAI_DAG_CMD_TENSORSET ||
+           op->commandType == REDISAI_DAG_CMD_TENSORGET;
+}
+
+// Returns true if one of op's inputs is an output of the op in the given index.
+static bool _DAG_OpDependsOn(RAI_DagOp *op, const int *producers, int op_index) {
+    for (size_t i = 0; i < array_len(op->inkeys_indices); i++) {
+        if (producers[op->inkeys_indices[i]] == op_index) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Split the DAG ops into chains, where every chain consists of ops of a single device
+ * and is executed (in order) by its own shallow copy of the DAG run info. Since
+ * every copy is a separate item in the device's run queue, ops that are in different
+ * chains can be executed in parallel by different workers of the device.
+ * A MODELRUN/SCRIPTRUN op is appended to a chain if the last such op in the chain is
+ * one of its direct dependencies (or if there is no such op in the chain yet), and
+ * otherwise it starts a new chain. So, a sequence of dependent ops is executed by a
+ * single copy, while independent ops (e.g. an ensemble of models that run on the same
+ * input) are executed by different copies. TENSORSET and TENSORGET ops do no work in
+ * the background, so they join the chain of the op that produces their input.
+ * Returns the copies, and sets the device index of every copy in copies_devices.
+ */
+static RedisAI_RunInfo **_DAG_CreateChainsCopies(RedisAI_RunInfo *rinfo, const char **devices,
+                                                 int **copies_devices) {
+    const int n_ops = rinfo->dagOpCount;
+    const size_t n_tensors = array_len(rinfo->dagSharedTensors);
+
+    // Map every tensor to the op that outputs it (-1 if the tensor was loaded).
+    int *producers = array_newlen(int, n_tensors);
+    for (size_t i = 0; i < n_tensors; i++) {
+        producers[i] = -1;
+    }
+    for (int i = 0; i < n_ops; i++) {
+        RAI_DagOp *op = rinfo->dagOps[i];
+        for (size_t j = 0; j < array_len(op->outkeys_indices); j++) {
+            producers[op->outkeys_indices[j]] = i;
+        }
+    }
+
+    RedisAI_RunInfo **copies = array_new(RedisAI_RunInfo *, array_len(devices));
+    int *chains_devices = array_new(int, array_len(devices));
+    // The index of the last MODELRUN/SCRIPTRUN op in every chain (-1 if there is none).
+    int *chains_last_ops = array_new(int, array_len(devices));
+    // The chain of every op.
+    int *ops_chains = array_newlen(int, n_ops);
+
+    for (int i = 0; i < n_ops; i++) {
+        RAI_DagOp *op = rinfo->dagOps[i];
+        int device = 0;
+        while (strcasecmp(op->devicestr, devices[device]) != 0) {
+            device++;
+        }
+        int chain = -1;
+        if (_DAG_IsLightOp(op)) {
+            for (size_t j = 0; j < array_len(op->inkeys_indices) && chain == -1; j++) {
+                int producer = producers[op->inkeys_indices[j]];
+                if (producer != -1 && chains_devices[ops_chains[producer]] == device) {
+                    chain = ops_chains[producer];
+                }
+            }
+            for (int c = 0; c < array_len(copies) && chain == -1; c++) {
+                if (chains_devices[c] == device) {
+                    chain = c;
+                }
+            }
+        } else {
+            for (int c = 0; c < array_len(copies) && chain == -1; c++) {
+                if (chains_devices[c] == device && chains_last_ops[c] != -1 &&
+                    _DAG_OpDependsOn(op, producers, chains_last_ops[c])) {
+                    chain = c;
+                }
+            }
+            for (int c = 0; c < array_len(copies) && chain == -1; c++) {
+                if (chains_devices[c] == device && chains_last_ops[c] == -1) {
+                    chain = c;
+                }
+            }
+        }
+        if (chain == -1) {
+            RedisAI_RunInfo *rinfo_copy;
+            RAI_ShallowCopyDagRunInfo(&rinfo_copy, rinfo);
+            copies = array_append(copies, rinfo_copy);
+            chains_devices = array_append(chains_devices, device);
+            chains_last_ops = array_append(chains_last_ops, -1);
+            chain = array_len(copies) - 1;
+        }
+        if (!_DAG_IsLightOp(op)) {
+            chains_last_ops[chain] = i;
+        }
+        ops_chains[i] = chain;
+        copies[chain]->dagDeviceOps = array_append(copies[chain]->dagDeviceOps, op);
+    }
+
+    for (size_t c = 0; c < array_len(copies); c++) {
+        copies[c]->dagDeviceOpCount = array_len(copies[c]->dagDeviceOps);
+    }
+    array_free(chains_last_ops);
+    array_free(ops_chains);
+    array_free(producers);
+    *copies_devices = chains_devices;
+    return copies;
+}
+
 // Add Shallow copies of the DAG run info to the devices' queues.
 // Return REDISMODULE_OK in case of success, REDISMODULE_ERR if (at least) one insert op had
 // failed.
@@ -88,48 +198,41 @@ int DAG_InsertDAGToQueue(RedisAI_RunInfo *rinfo) {
         }
     }
 
-    size_t ndevices = array_len(devices);
-    if (ndevices == 1)
-        rinfo->single_device_dag = 1;
-    RedisAI_RunInfo **rinfo_copies = array_new(RedisAI_RunInfo *, ndevices);
+    // The copies inherit the queuing time of the original run info, which is
+    // used for end-to-end latency stats once the whole DAG is done.
+    gettimeofday(&rinfo->queuingTime, NULL);
+    int *copies_devices;
+    RedisAI_RunInfo **rinfo_copies = _DAG_CreateChainsCopies(rinfo, devices, &copies_devices);
+    size_t ncopies = array_len(rinfo_copies);
 
-    for (long long i = 0; i < ndevices; i++) {
-        RedisAI_RunInfo *rinfo_copy;
-        RAI_ShallowCopyDagRunInfo(&rinfo_copy, rinfo);
-        rinfo_copies = array_append(rinfo_copies, rinfo_copy);
+    // If all the ops are executed by a single copy, no two ops can run concurrently, so
+    // there is no need to lock the DAG tensors context.
+    for (size_t i = 0; i < ncopies; i++) {
+        rinfo_copies[i]->single_chain_dag = ncopies == 1;
+        rinfo_copies[i]->runQueue = RunQueue_GetInfo(devices[copies_devices[i]]);
     }
+    rinfo->single_chain_dag = ncopies == 1;
 
-    for (long long i = 0; i < ndevices; i++) {
-        RedisAI_RunInfo *rinfo_copy = rinfo_copies[i];
-        for (long long j = 0; j < rinfo_copy->dagOpCount; j++) {
-            if (strcasecmp(rinfo_copy->dagOps[j]->devicestr, devices[i]) == 0) {
-                rinfo_copy->dagDeviceOps =
-                    array_append(rinfo_copy->dagDeviceOps, rinfo_copy->dagOps[j]);
-            }
+    // Let the models that batch adaptively observe the rate of incoming requests.
+    const long long now = ustime();
+    for (long long i = 0; i < rinfo->dagOpCount; i++) {
+        RAI_BatchingProfile *profile = RedisAI_DagOpBatchingProfile(rinfo->dagOps[i]);
+        if (profile) {
+            RAI_BatchingProfileAddArrival(profile, now);
         }
-        rinfo_copy->dagDeviceOpCount = array_len(rinfo_copy->dagDeviceOps);
-    }
-
-    RunQueueInfo **run_queues_info = array_new(RunQueueInfo *, ndevices);
-    for (long long i = 0; i < ndevices; i++) {
-        const char *device_str = devices[i];
-        RunQueueInfo *run_queue_info = RunQueue_GetInfo(device_str);
-        run_queues_info = array_append(run_queues_info, run_queue_info);
     }
-    for (long long i = 0; i < ndevices; i++) {
-        RedisAI_RunInfo *rinfo_copy = rinfo_copies[i];
-        RunQueueInfo *run_queue_info = run_queues_info[i];
-        gettimeofday(&rinfo_copy->queuingTime, NULL);
 
-        pthread_mutex_lock(&run_queue_info->run_queue_mutex);
-        queuePush(run_queue_info->run_queue, rinfo_copy);
-        pthread_cond_signal(&run_queue_info->queue_condition_var);
-        pthread_mutex_unlock(&run_queue_info->run_queue_mutex);
+    // A copy enters its run queue only once its first op is ready. Otherwise, it
+    // waits until the copies that produce the missing inputs push it.
+    for (size_t i = 0; i < ncopies; i++) {
+        if (!RedisAI_DagWaitForInputs(rinfo_copies[i])) {
+            RunQueue_Push(rinfo_copies[i]->runQueue, rinfo_copies[i]);
+        }
     }
 
     array_free(devices);
+    array_free(copies_devices);
     array_free(rinfo_copies);
-    array_free(run_queues_info);
     return REDISMODULE_OK;
 }
 
@@ -27,6 +27,7 @@ int RAI_InitDagOp(RAI_DagOp **result) {
     dagOp->ectx = NULL;
     dagOp->devicestr = NULL;
     dagOp->duration_us = 0;
+    dagOp->queue_wait_us = 0;
     dagOp->result = -1;
     RAI_InitError(&dagOp->err);
     dagOp->argv = NULL;
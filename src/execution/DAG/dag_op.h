@@ -34,6 +34,7 @@ typedef struct RAI_DagOp {
     char *devicestr;
     int result; // REDISMODULE_OK or REDISMODULE_ERR
     long long duration_us;
+    long long queue_wait_us; // Time from enqueuing the op until it started running.
     RAI_Error *err;
     RedisModuleString **argv;
     int argc;
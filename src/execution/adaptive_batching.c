@@ -0,0 +1,173 @@
+/*
+ *Copyright Redis Ltd. 2018 - present
+ *Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ *the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "adaptive_batching.h"
+#include "redismodule.h"
+
+// Weights of a new sample in the moving averages (as in TCP's RTT estimation).
+#define MEAN_SHIFT 3 // 1/8
+#define DEV_SHIFT  2 // 1/4
+// The tail (p99) execution time is estimated as mean + TAIL_DEVS * deviation.
+#define TAIL_DEVS 4
+
+#define LOAD(x)     __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+
+static long long _EntryTail(RAI_BatchingProfileEntry *entry) {
+    long long mean = LOAD(entry->mean_us);
+    if (mean == 0) {
+        return 0;
+    }
+    return mean + TAIL_DEVS * LOAD(entry->dev_us);
+}
+
+/**
+ * @brief Estimate the tail execution time of a batch of the given size, or return
+ * -1 if nothing was measured yet. The execution time is assumed to be monotonic in
+ * the batch size: an unmeasured size is bounded by the nearest larger measured one,
+ * or else extrapolated linearly from the nearest smaller measured one.
+ */
+static long long _BatchingProfileTail(RAI_BatchingProfile *profile, size_t batchsize) {
+    for (size_t i = batchsize; i <= profile->batchsize; i++) {
+        long long tail = _EntryTail(&profile->entries[i - 1]);
+        if (tail > 0) {
+            return tail;
+        }
+    }
+    for (size_t i = batchsize - 1; i > 0; i--) {
+        long long tail = _EntryTail(&profile->entries[i - 1]);
+        if (tail > 0) {
+            return tail * batchsize / i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Age the entries of the batch sizes that are larger than the given (just
+ * measured) entry. Running a batch of size n should not take longer than running
+ * it in n/batchsize smaller batches, so a larger entry whose estimates exceed the
+ * linear extrapolation from this one is stale (e.g., it was measured once while the
+ * backend was warming up, and since the target batch size dropped below it, it is
+ * never measured again). Such entries decay toward the extrapolated estimates, at
+ * the same rate as they would with new samples.
+ */
+static void _BatchingProfileAgeLarger(RAI_BatchingProfile *profile, size_t batchsize,
+                                      RAI_BatchingProfileEntry *entry) {
+    long long mean = LOAD(entry->mean_us);
+    long long dev = LOAD(entry->dev_us);
+    for (size_t i = batchsize + 1; i <= profile->batchsize; i++) {
+        RAI_BatchingProfileEntry *larger = &profile->entries[i - 1];
+        long long larger_mean = LOAD(larger->mean_us);
+        if (larger_mean == 0) {
+            continue;
+        }
+        long long max_mean = mean * i / batchsize;
+        long long max_dev = dev * i / batchsize;
+        if (larger_mean > max_mean) {
+            larger_mean += (max_mean - larger_mean) >> MEAN_SHIFT;
+            STORE(larger->mean_us, larger_mean > 0 ? larger_mean : 1);
+        }
+        long long larger_dev = LOAD(larger->dev_us);
+        if (larger_dev > max_dev) {
+            larger_dev += (max_dev - larger_dev) >> DEV_SHIFT;
+            STORE(larger->dev_us, larger_dev);
+        }
+    }
+}
+
+RAI_BatchingProfile *RAI_BatchingProfileCreate(size_t batchsize, size_t latencytarget_ms) {
+    RAI_BatchingProfile *profile = RedisModule_Calloc(1, sizeof(*profile));
+    profile->batchsize = batchsize;
+    profile->target_us = (long long)latencytarget_ms * 1000;
+    profile->entries = RedisModule_Calloc(batchsize, sizeof(*profile->entries));
+    return profile;
+}
+
+void RAI_BatchingProfileFree(RAI_BatchingProfile *profile) {
+    RedisModule_Free(profile->entries);
+    RedisModule_Free(profile);
+}
+
+void RAI_BatchingProfileAddArrival(RAI_BatchingProfile *profile, long long now_us) {
+    long long last = __atomic_exchange_n(&profile->last_arrival_us, now_us, __ATOMIC_RELAXED);
+    if (last == 0 || now_us < last) {
+        return;
+    }
+    long long sample = now_us - last;
+    long long avg = LOAD(profile->interarrival_us);
+    if (avg == 0) {
+        STORE(profile->interarrival_us, sample > 0 ? sample : 1);
+        return;
+    }
+    avg += (sample - avg) >> MEAN_SHIFT;
+    STORE(profile->interarrival_us, avg > 0 ? avg : 1);
+}
+
+void RAI_BatchingProfileAddRun(RAI_BatchingProfile *profile, size_t batchsize,
+                               long long duration_us) {
+    if (batchsize == 0 || batchsize > profile->batchsize) {
+        return;
+    }
+    if (duration_us <= 0) {
+        duration_us = 1;
+    }
+    RAI_BatchingProfileEntry *entry = &profile->entries[batchsize - 1];
+    long long mean = LOAD(entry->mean_us);
+    if (mean == 0) {
+        STORE(entry->dev_us, duration_us / 2);
+        STORE(entry->mean_us, duration_us);
+    } else {
+        long long err = duration_us - mean;
+        long long dev = LOAD(entry->dev_us);
+        dev += ((err < 0 ? -err : err) - dev) >> DEV_SHIFT;
+        mean += err >> MEAN_SHIFT;
+        STORE(entry->dev_us, dev);
+        STORE(entry->mean_us, mean > 0 ? mean : 1);
+    }
+    _BatchingProfileAgeLarger(profile, batchsize, entry);
+}
+
+size_t RAI_BatchingProfileTargetBatchSize(RAI_BatchingProfile *profile) {
+    for (size_t batchsize = profile->batchsize; batchsize > 0; batchsize--) {
+        long long tail = _BatchingProfileTail(profile, batchsize);
+        if (tail < 0) {
+            // Nothing was measured yet - start with the largest batches allowed.
+            return profile->batchsize;
+        }
+        if (tail <= profile->target_us) {
+            return batchsize;
+        }
+    }
+    // Even a single item exceeds the target, so don't batch at all.
+    return 1;
+}
+
+long long RAI_BatchingProfileWaitTime(RAI_BatchingProfile *profile, size_t target_batchsize,
+                                      size_t current_batchsize, size_t nrequests,
+                                      long long elapsed_us) {
+    if (current_batchsize == 0 || current_batchsize >= target_batchsize) {
+        return 0;
+    }
+    long long tail = _BatchingProfileTail(profile, target_batchsize);
+    if (tail < 0) {
+        tail = 0;
+    }
+    // The time that we can still spend waiting, such that the oldest request will
+    // complete within the target even if the batch is run at its full target size.
+    long long slack = profile->target_us - elapsed_us - tail;
+    long long interarrival = LOAD(profile->interarrival_us);
+    if (slack <= 0 || interarrival == 0 || interarrival > slack) {
+        // Either there is no time left, or no more requests are expected in time.
+        return 0;
+    }
+    // The number of requests that are missing to fill the batch, assuming that the
+    // next requests have the same size as the ones collected so far.
+    size_t missing = target_batchsize - current_batchsize;
+    long long missing_requests = (missing * nrequests + current_batchsize - 1) / current_batchsize;
+    long long fill_us = missing_requests * interarrival;
+    return fill_us < slack ? fill_us : slack;
+}
@@ -0,0 +1,74 @@
+/*
+ *Copyright Redis Ltd. 2018 - present
+ *Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ *the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+/**
+ * Contains the latency profile that drives adaptive batching for models that were
+ * stored with LATENCYTARGET. Instead of a static MINBATCHSIZE/MINBATCHTIMEOUT, the
+ * workers use the execution times observed for every batch size together with the
+ * observed request inter-arrival time to decide how large a batch should be and
+ * how long it is worth waiting for it, so that the tail latency of the requests
+ * (from enqueuing to completion) stays within the target.
+ *
+ * The profile is updated by the workers that run the model and read by the workers
+ * that collect batches, concurrently. All of its fields are accessed with relaxed
+ * atomics - racing updates may lose a sample, which is harmless for estimates.
+ */
+
+#include <stddef.h>
+
+typedef struct RAI_BatchingProfileEntry {
+    long long mean_us; // moving average of the execution time (0 if not measured yet).
+    long long dev_us;  // moving average of the absolute deviation from the mean.
+} RAI_BatchingProfileEntry;
+
+typedef struct RAI_BatchingProfile {
+    size_t batchsize;          // The model's BATCHSIZE.
+    long long target_us;       // The model's LATENCYTARGET in microseconds.
+    long long interarrival_us; // moving average of the time between requests.
+    long long last_arrival_us;
+    RAI_BatchingProfileEntry *entries; // Indexed by (batch size - 1).
+} RAI_BatchingProfile;
+
+/**
+ * @brief Create an empty profile for a model with the given batchsize and latency
+ * target (in milliseconds).
+ */
+RAI_BatchingProfile *RAI_BatchingProfileCreate(size_t batchsize, size_t latencytarget_ms);
+
+void RAI_BatchingProfileFree(RAI_BatchingProfile *profile);
+
+/**
+ * @brief Record that a request to run the model was enqueued at now_us.
+ */
+void RAI_BatchingProfileAddArrival(RAI_BatchingProfile *profile, long long now_us);
+
+/**
+ * @brief Record that a run of the model over a batch of the given size (in the 0-th
+ * dimension) took duration_us. Batches larger than the model's batchsize are ignored.
+ * Estimates of larger batch sizes that are slower than the linear extrapolation from
+ * this one decay toward it, so that a slow outlier (such as a warm-up run) does not
+ * cap the target batch size forever.
+ */
+void RAI_BatchingProfileAddRun(RAI_BatchingProfile *profile, size_t batchsize,
+                               long long duration_us);
+
+/**
+ * @brief Returns the largest batch size whose estimated tail execution time fits in
+ * the latency target. Before any measurement was made, this is the model's batchsize.
+ */
+size_t RAI_BatchingProfileTargetBatchSize(RAI_BatchingProfile *profile);
+
+/**
+ * @brief Returns how long (in microseconds) it is worth waiting for more requests
+ * before running a batch that currently holds current_batchsize items out of
+ * nrequests requests, where the oldest request was enqueued elapsed_us ago, and the
+ * batch should reach target_batchsize. Returns 0 if the batch should run now.
+ */
+long long RAI_BatchingProfileWaitTime(RAI_BatchingProfile *profile, size_t target_batchsize,
+                                      size_t current_batchsize, size_t nrequests,
+                                      long long elapsed_us);
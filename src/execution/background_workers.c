@@ -43,25 +43,43 @@ static void _BGWorker_SaveThreadId() {
 }
 
 /**
- * @brief In case a DAG Op can express a MINBATCHSIZE > 0 with a MINBATCHTIMEOUT
- * in milliseconds, we will use a timedwait of one millisecond to evaluate
- * whether the run needs to trigger in case nothing else happens on the queue.
- * Possible optimization: opt for a longer timeout if there's no
- * minbatchtimeout involved.
+ * @brief Compute the point in time which is timeout_msec milliseconds after start.
  */
-static void _BGThread_Wait(RunQueueInfo *run_queue_info) {
-    struct timeval now;
-    gettimeofday(&now, NULL);
+static void _BGThread_GetExpiry(const struct timeval *start, size_t timeout_msec,
+                                struct timeval *expiry) {
+    struct timeval timeout = {.tv_sec = timeout_msec / 1000,
+                              .tv_usec = (timeout_msec % 1000) * 1000};
+    timeradd(start, &timeout, expiry);
+}
 
-    struct timespec absTimeout;
-    absTimeout.tv_sec = now.tv_sec;
-    absTimeout.tv_nsec = (now.tv_usec + 1000) * 1000; // 1 millisecond
+/**
+ * @brief Returns true if timeout_msec milliseconds have passed since start.
+ */
+static bool _BGThread_IsExpired(const struct timeval *start, size_t timeout_msec) {
+    struct timeval now, expiry;
+    gettimeofday(&now, NULL);
+    _BGThread_GetExpiry(start, timeout_msec, &expiry);
+    return !timercmp(&now, &expiry, <);
+}
 
-    pthread_cond_timedwait(&run_queue_info->queue_condition_var, &run_queue_info->run_queue_mutex,
-                           &absTimeout);
+/**
+ * @brief Set the deadline to the given expiry time, if it is earlier than the
+ * current one. An unset deadline (zero) means that there is no deadline.
+ */
+static void _BGThread_UpdateDeadline(struct timeval *deadline, const struct timeval *expiry) {
+    if (!timerisset(deadline) || timercmp(expiry, deadline, <)) {
+        *deadline = *expiry;
+    }
 }
 
 static void _BGThread_SaveStats(RedisAI_RunInfo *rinfo) {
+    // The end-to-end latency of every op is measured from enqueuing the DAG until
+    // the entire DAG is done (that is, until the client is about to be unblocked).
+    struct timeval now, total;
+    gettimeofday(&now, NULL);
+    timersub(&now, &rinfo->queuingTime, &total);
+    long long total_us = total.tv_sec * 1000000LL + total.tv_usec;
+
     for (size_t i = 0; i < rinfo->dagOpCount; i++) {
         RAI_DagOp *currentOp = rinfo->dagOps[i];
 
@@ -84,6 +102,8 @@ static void _BGThread_SaveStats(RedisAI_RunInfo *rinfo) {
                 }
                 RAI_StatsAddDataPoint(RAI_ExecutionCtx_GetStats(currentOp->ectx),
                                       currentOp->duration_us, 1, 0, batch_size);
+                RAI_StatsAddLatencies(RAI_ExecutionCtx_GetStats(currentOp->ectx),
+                                      currentOp->duration_us, currentOp->queue_wait_us, total_us);
             }
         }
     }
@@ -105,29 +125,66 @@ static bool _BGThread_IsRInfoTimedOut(RedisAI_RunInfo *rinfo) {
     if (RedisAI_DagTimeout(rinfo)) {
         return true;
     }
-    if (rinfo->timeout > 0) {
-        struct timeval now, sub;
-        gettimeofday(&now, NULL);
-        timersub(&now, &rinfo->queuingTime, &sub);
-        size_t time_msec = sub.tv_sec * 1000 + sub.tv_usec / 1000;
-        if (time_msec > rinfo->timeout) {
-            RedisAI_DagSetTimeout(rinfo);
-            return true;
-        }
+    if (rinfo->timeout > 0 && _BGThread_IsExpired(&rinfo->queuingTime, rinfo->timeout)) {
+        RedisAI_DagSetTimeout(rinfo);
+        return true;
     }
     return false;
 }
 
+/**
+ * @brief Called when a run info is left in the queue without being executed. If the
+ * run info has a timeout, its expiry sets the deadline for re-examining the queue.
+ * If the run info was deferred since its batch was not ready, the point in time in
+ * which the batch becomes ready anyway (batch_expiry, if set) sets the deadline as
+ * well.
+ */
+static void _BGThread_Defer(RedisAI_RunInfo *rinfo, const struct timeval *batch_expiry,
+                            struct timeval *deadline) {
+    struct timeval expiry;
+    if (rinfo->timeout > 0) {
+        _BGThread_GetExpiry(&rinfo->queuingTime, rinfo->timeout, &expiry);
+        _BGThread_UpdateDeadline(deadline, &expiry);
+    }
+    if (batch_expiry && timerisset(batch_expiry)) {
+        _BGThread_UpdateDeadline(deadline, batch_expiry);
+    }
+}
+
+/**
+ * @brief Push the copies of the DAGs in the batch whose current op became ready
+ * (since this step produced their missing inputs), to their run queues. If a DAG
+ * has failed, its waiting copies are pushed as well, so they will be finished.
+ */
+static void _BGThread_PushReadyCopies(RedisAI_RunInfo **batch_rinfo,
+                                      RedisAI_RunInfo ***ready_rinfo) {
+    array_clear(*ready_rinfo);
+    for (size_t i = 0; i < array_len(batch_rinfo); i++) {
+        *ready_rinfo = RedisAI_DagTakeReadyCopies(batch_rinfo[i], *ready_rinfo);
+    }
+    for (size_t i = 0; i < array_len(*ready_rinfo); i++) {
+        RedisAI_RunInfo *rinfo = (*ready_rinfo)[i];
+        RunQueue_Push(rinfo->runQueue, rinfo);
+    }
+}
+
 static int *_BGThread_ExecutionFinish(RedisAI_RunInfo **batch_rinfo) {
     int *unfinished_rinfos_indices = array_new(int, array_len(batch_rinfo));
     for (int i = array_len(batch_rinfo) - 1; i >= 0; i--) {
         RedisAI_RunInfo *rinfo = batch_rinfo[i];
         rinfo->dagDeviceCompleteOpCount += 1;
+        // The current op has changed, and so has its batching signature.
+        if (rinfo->batchingSignature) {
+            array_free(rinfo->batchingSignature);
+            rinfo->batchingSignature = NULL;
+        }
         __atomic_add_fetch(rinfo->dagCompleteOpCount, 1, __ATOMIC_RELAXED);
         if (RedisAI_DagDeviceComplete(rinfo) || RedisAI_DagError(rinfo) ||
             RedisAI_DagTimeout(rinfo)) {
             _BGThread_RinfoFinish(rinfo);
-        } else {
+        } else if (!RedisAI_DagWaitForInputs(rinfo)) {
+            // The next op is ready, otherwise the run info is pushed once the
+            // inputs are produced.
             unfinished_rinfos_indices = array_append(unfinished_rinfos_indices, i);
         }
     }
@@ -148,10 +205,15 @@ static void _BGThread_Execute(RunQueueInfo *run_queue_info, RedisAI_RunInfo **ba
     }
 }
 
+/**
+ * @brief Collect the run infos that can be batched with rinfo into batch_rinfo. If the
+ * batch should not run yet, batchReady is set to false, and batchExpiry is set to the
+ * point in time in which it should run anyway (or left unset if there is none).
+ */
 static RedisAI_RunInfo **_BGThread_BatchOperations(RunQueueInfo *run_queue_info,
                                                    RedisAI_RunInfo *rinfo,
                                                    RedisAI_RunInfo **batch_rinfo,
-                                                   bool *batchReady) {
+                                                   bool *batchReady, struct timeval *batchExpiry) {
     // Since the current op can be batched, then we collect info on batching, namely
     // - batchsize
     // - minbatchsize
@@ -162,13 +224,25 @@ static RedisAI_RunInfo **_BGThread_BatchOperations(RunQueueInfo *run_queue_info,
     RedisAI_DagOpBatchInfo(rinfo, currentOp, &batchsize, &minbatchsize, &minbatchtimeout,
                            &inbatchsize);
 
+    const size_t max_batchsize = batchsize;
+    // With adaptive batching, the batch is capped at the largest size that is
+    // expected to run within the model's latency target.
+    RAI_BatchingProfile *profile = RedisAI_DagOpBatchingProfile(currentOp);
+    if (profile) {
+        batchsize = RAI_BatchingProfileTargetBatchSize(profile);
+    }
+
     // Get the size of the batch so far, that is, the size of the first input
     // tensor in the 0-th dimension
     size_t current_batchsize = inbatchsize;
 
     // If the size is zero or if it already exceeds the desired batch size
     // then stop searching
-    if (current_batchsize == 0 || current_batchsize >= batchsize) {
+    if (current_batchsize == 0) {
+        return batch_rinfo;
+    }
+    if (current_batchsize >= batchsize) {
+        RunQueue_RecordBatch(run_queue_info, current_batchsize, max_batchsize);
         return batch_rinfo;
     }
 
@@ -179,55 +253,22 @@ static RedisAI_RunInfo **_BGThread_BatchOperations(RunQueueInfo *run_queue_info,
     // if the timeout for min batch has expired, in which case we proceed
     // anyway
     if (minbatchsize > 0 && minbatchtimeout > 0) {
-        struct timeval now, sub;
-        gettimeofday(&now, NULL);
-
-        timersub(&now, &rinfo->queuingTime, &sub);
-        size_t time_msec = sub.tv_sec * 1000 + sub.tv_usec / 1000;
-
-        if (time_msec > minbatchtimeout) {
-            timeout = true;
-        }
+        timeout = _BGThread_IsExpired(&rinfo->queuingTime, minbatchtimeout);
     }
 
-    // Get the next item in the queue
-    queueItem *next_item = queueFront(run_queue_info->run_queue);
-
-    // While we don't reach the end of the queue
-    while (next_item != NULL && !timeout) {
-        // Get the next run info
-        RedisAI_RunInfo *next_rinfo = (RedisAI_RunInfo *)next_item->value;
-
-        // If the next item is batchable, that is, if it is a model, if it
-        // is a call to the same model, and if the size of the inputs except
-        // the 0-th dimension match, then go on, otherwise continue to the
-        // next item in the queue
-        RAI_DagOp *nextOp = RedisAI_DagCurrentOp(next_rinfo);
-
-        bool nextOpReady, nextOpBatchable;
-        RedisAI_DagCurrentOpInfo(next_rinfo, &nextOpReady, &nextOpBatchable);
-
-        if (nextOpReady == 0 || nextOpBatchable == 0) {
-            next_item = queueNext(next_item);
-            continue;
-        }
-
-        int batched = 0;
-        size_t next_batchsize = 0;
-        RedisAI_DagOpBatchingMatch(rinfo, currentOp, next_rinfo, nextOp, &batched, &next_batchsize);
-
-        if (batched == 0) {
-            next_item = queueNext(next_item);
-            continue;
-        }
-
-        // If all previous checks pass, then keep track of the item
-        // in the list of evicted items
-        queueItem *tmp = queueNext(next_item);
-        queueItem *evicted = queueEvict(run_queue_info->run_queue, next_item);
-        RedisModule_Free(evicted);
-        next_item = tmp;
+    // Get the next item in the queue that can be batched with the current op, that
+    // is, a call to the same model, whose inputs sizes (except for the 0-th
+    // dimension) match. These items are kept in a batching lane in the order in
+    // which they appear in the queue, so we don't need to scan the entire queue.
+    // The items are only collected here, they are evicted from the queue once the
+    // batch is ready.
+    RedisAI_RunInfo *next_rinfo = RunQueue_BatchingLaneNext(rinfo);
+
+    // While we don't reach the end of the lane
+    while (next_rinfo != NULL && !timeout) {
+        size_t next_batchsize = RAI_DagOpBatchSize(RedisAI_DagCurrentOp(next_rinfo), next_rinfo);
         batch_rinfo = array_append(batch_rinfo, next_rinfo);
+        next_rinfo = RunQueue_BatchingLaneNext(next_rinfo);
 
         // Update the batchsize and go to the next item to see if
         // there's anything else to batch
@@ -235,7 +276,6 @@ static RedisAI_RunInfo **_BGThread_BatchOperations(RunQueueInfo *run_queue_info,
 
         // If the new batch size would exceed the prescribed batch
         // size, then quit searching.
-        // Here we could consider searching further down the queue.
         if (current_batchsize >= batchsize) {
             break;
         }
@@ -244,46 +284,63 @@ static RedisAI_RunInfo **_BGThread_BatchOperations(RunQueueInfo *run_queue_info,
         // if the timeout for min batch has expired, in which case we proceed
         // anyway
         if (minbatchsize > 0 && minbatchtimeout > 0) {
-            struct timeval now, sub;
-            gettimeofday(&now, NULL);
-
-            timersub(&now, &rinfo->queuingTime, &sub);
-            size_t time_msec = sub.tv_sec * 1000 + sub.tv_usec / 1000;
-
-            if (time_msec > minbatchtimeout) {
-                timeout = true;
-            }
+            timeout = _BGThread_IsExpired(&rinfo->queuingTime, minbatchtimeout);
         }
     }
     if (minbatchsize != 0 && current_batchsize < minbatchsize) {
         // The batch is ready with respect to minbatch only if there was a timeout.
         *batchReady = timeout;
+        if (!timeout && minbatchtimeout > 0) {
+            _BGThread_GetExpiry(&rinfo->queuingTime, minbatchtimeout, batchExpiry);
+        }
+    }
+    if (profile) {
+        // Wait for more run infos only as long as the latency target of the
+        // oldest one in the batch allows it.
+        struct timeval now, elapsed;
+        gettimeofday(&now, NULL);
+        timersub(&now, &rinfo->queuingTime, &elapsed);
+        long long elapsed_us = elapsed.tv_sec * 1000000LL + elapsed.tv_usec;
+        long long wait_us = RAI_BatchingProfileWaitTime(profile, batchsize, current_batchsize,
+                                                        array_len(batch_rinfo), elapsed_us);
+        if (wait_us > 0) {
+            *batchReady = false;
+            struct timeval wait = {.tv_sec = wait_us / 1000000, .tv_usec = wait_us % 1000000};
+            timeradd(&now, &wait, batchExpiry);
+        }
+    }
+    if (*batchReady) {
+        RunQueue_RecordBatch(run_queue_info, current_batchsize, max_batchsize);
     }
     return batch_rinfo;
 }
 
 static bool _BGThread_PrepareExecution(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo,
-                                       RedisAI_RunInfo ***batch_rinfo) {
-    // Get if the operation is ready and bacthable
-    bool currentOpReady, currentOpBatchable;
-    RedisAI_DagCurrentOpInfo(rinfo, &currentOpReady, &currentOpBatchable);
-    if (currentOpReady) {
-        *batch_rinfo = array_append(*batch_rinfo, rinfo);
-    } else {
-        // Op is not ready - push back to queue and continue the loop.
-        queuePush(run_queue_info->run_queue, rinfo);
+                                       RedisAI_RunInfo ***batch_rinfo, struct timeval *deadline) {
+    // If the batch of the lane that this run info belongs to was already found not
+    // ready in this pass, so is the batch of this run info.
+    if (RunQueue_IsBatchingLaneDeferred(run_queue_info, rinfo)) {
+        _BGThread_Defer(rinfo, NULL, deadline);
         return false;
     }
-
-    if (currentOpBatchable) {
+    // A run info enters the queue only once its current op is ready (see
+    // RedisAI_DagWaitForInputs), so we only need to check if it is batchable.
+    *batch_rinfo = array_append(*batch_rinfo, rinfo);
+    if (RedisAI_DagCurrentOpBatchable(rinfo)) {
         bool batchReady = true;
-        *batch_rinfo = _BGThread_BatchOperations(run_queue_info, rinfo, *batch_rinfo, &batchReady);
+        struct timeval batchExpiry;
+        timerclear(&batchExpiry);
+        *batch_rinfo = _BGThread_BatchOperations(run_queue_info, rinfo, *batch_rinfo, &batchReady,
+                                                 &batchExpiry);
         if (!batchReady) {
             // Batch is not ready - batch size didn't match the expectations from
-            // minbatchsize
-            for (int i = array_len(*batch_rinfo) - 1; i >= 0; i--) {
-                queuePush(run_queue_info->run_queue, (*batch_rinfo)[i]);
-            }
+            // minbatchsize, or the adaptive policy decided to wait for more run
+            // infos. The batch will be ready once the MINBATCHTIMEOUT of its first
+            // run info (or the adaptive waiting time) expires, unless more run
+            // infos arrive. The run infos of the lane stay in place (so the lane
+            // stays FIFO), and the lane is skipped for the rest of this pass.
+            RunQueue_DeferBatchingLane(run_queue_info, rinfo);
+            _BGThread_Defer(rinfo, &batchExpiry, deadline);
             return false;
         }
     }
@@ -304,27 +361,41 @@ void *BGWorker_ThreadMain(void *arg) {
     _BGWorker_SaveThreadId();
     RunQueueInfo *run_queue_info = (RunQueueInfo *)arg;
     RedisAI_RunInfo **batch_rinfo = array_new(RedisAI_RunInfo *, 1);
+    RedisAI_RunInfo **ready_rinfo = array_new(RedisAI_RunInfo *, 1);
     pthread_mutex_lock(&run_queue_info->run_queue_mutex);
 
     while (true) {
-        _BGThread_Wait(run_queue_info);
-        // This is the length of the queue for this particular device
-        // (see run_queue_info->devicestr).
-        // There might be more than one thread operating on the same
-        // queue, according to the THREADS_PER_QUEUE config variable.
-        while (queueFront(run_queue_info->run_queue)) {
-            array_clear(batch_rinfo);
-            // We first peek the front of the queue
-            queueItem *item = queuePop(run_queue_info->run_queue);
+        // The earliest point in time in which a run info that was left in the
+        // queue has to be re-examined, even if nothing else happens on the queue
+        // (unset if there is no such run info).
+        struct timeval deadline;
+        timerclear(&deadline);
+        RunQueue_DrainInbox(run_queue_info);
+        // Every pass over the queue for this particular device (see
+        // run_queue_info->devicestr) examines each run info once at most. There
+        // might be more than one thread operating on the same queue, according to
+        // the THREADS_PER_QUEUE config variable.
+        RunQueue_StartPass(run_queue_info);
+        queueItem *item = queueFront(run_queue_info->run_queue);
+        while (item) {
             RedisAI_RunInfo *rinfo = (RedisAI_RunInfo *)item->value;
-            RedisModule_Free(item);
+            item = queueNext(item);
+            array_clear(batch_rinfo);
             // In case of timeout or error - skip execution.
             bool skip_execution = _BGThread_IsRInfoTimedOut(rinfo) || RedisAI_DagError(rinfo);
-            // Prepare to execution, if the op or the batch is not ready, exit
-            // the loop, give a chance to new tasks to submit.
+            // Prepare to execution, if the batch is not ready, the run info stays
+            // in the queue and we move on to the next item.
             if (!skip_execution &&
-                !_BGThread_PrepareExecution(run_queue_info, rinfo, &batch_rinfo)) {
-                break;
+                !_BGThread_PrepareExecution(run_queue_info, rinfo, &batch_rinfo, &deadline)) {
+                continue;
+            }
+            if (skip_execution) {
+                RunQueue_Evict(run_queue_info, rinfo);
+                RunQueue_RecordDequeue(run_queue_info, rinfo);
+            }
+            for (size_t i = 0; i < array_len(batch_rinfo); i++) {
+                RunQueue_Evict(run_queue_info, batch_rinfo[i]);
+                RunQueue_RecordDequeue(run_queue_info, batch_rinfo[i]);
             }
             // Run the computation step (batched or not)
             // We're done with the queue here, items have been evicted so we can
@@ -332,6 +403,7 @@ void *BGWorker_ThreadMain(void *arg) {
             // on the same queue. The evicted items at this point are only visible
             // to this worker.
             pthread_mutex_unlock(&run_queue_info->run_queue_mutex);
+            const long long busy_start = ustime();
             if (!skip_execution) {
                 _BGThread_Execute(run_queue_info, batch_rinfo);
             } else {
@@ -339,19 +411,35 @@ void *BGWorker_ThreadMain(void *arg) {
                 // we consider the batch as contains this single dag when finish.
                 batch_rinfo = array_append(batch_rinfo, rinfo);
             }
+            // Other copies of the DAGs in the batch might be waiting for the
+            // outputs of this step (or for its failure).
+            _BGThread_PushReadyCopies(batch_rinfo, &ready_rinfo);
             // For every DAG in the batch: if the entire DAG run is complete,
             // call the on finish callback. Otherwise, save the DAG index in
             // the batch_rinfo array, so we reinsert the DAG to the queue
-            // (after acquiring the queue lock).
+            // (after acquiring the queue lock), unless its next op waits for
+            // inputs that other copies produce.
             int *unfinished_rinfo_indices = _BGThread_ExecutionFinish(batch_rinfo);
+            RunQueue_RecordBusyTime(run_queue_info, ustime() - busy_start);
             pthread_mutex_lock(&run_queue_info->run_queue_mutex);
 
             // Reinsert the unfinished DAG's run info to the queue.
             for (size_t i = 0; i < array_len(unfinished_rinfo_indices); i++) {
-                queuePushFront(run_queue_info->run_queue, batch_rinfo[unfinished_rinfo_indices[i]]);
+                RunQueue_Reinsert(run_queue_info, batch_rinfo[unfinished_rinfo_indices[i]]);
             }
             array_free(unfinished_rinfo_indices);
+            RunQueue_DrainInbox(run_queue_info);
+
+            // The queue might have changed while the mutex was released, so every
+            // item should be examined again.
+            RunQueue_StartPass(run_queue_info);
+            item = queueFront(run_queue_info->run_queue);
+            timerclear(&deadline);
         }
+        // Nothing in the queue can be executed at the moment - sleep until a new
+        // run info is pushed, or until the earliest pending deadline.
+        RunQueue_Wait(run_queue_info, &deadline);
     }
     array_free(batch_rinfo);
+    array_free(ready_rinfo);
 }
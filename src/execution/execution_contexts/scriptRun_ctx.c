@@ -113,6 +113,60 @@ int RAI_ScriptRun(RAI_ScriptRunCtx *sctx, RAI_Error *err) {
     return RAI_backends.torch.script_run(script, sctx->fnname, &sctx->base, err);
 }
 
+int RAI_ScriptRunBatched(RAI_ScriptRunCtx **sctxs, size_t n, RAI_Error *err) {
+    RAI_ScriptRunCtx *first = sctxs[0];
+    RAI_ScriptRunCtx *batched = RAI_ScriptRunCtxCreate(first->script, first->fnname);
+    for (size_t i = 0; i < array_len(first->keys); i++) {
+        RAI_ScriptRunCtxAddKeyInput(batched, RAI_HoldString(first->keys[i]));
+    }
+    for (size_t i = 0; i < array_len(first->args); i++) {
+        RAI_ScriptRunCtxAddArgInput(batched, RAI_HoldString(first->args[i]));
+    }
+
+    size_t batch_sizes[n];
+    size_t batch_offsets[n];
+    size_t total_batch_size = 0;
+    for (size_t b = 0; b < n; b++) {
+        RAI_Tensor *input = RAI_ExecutionCtx_GetInput(&sctxs[b]->base, 0);
+        batch_sizes[b] = RAI_TensorDim(input, 0);
+        batch_offsets[b] = total_batch_size;
+        total_batch_size += batch_sizes[b];
+    }
+
+    const size_t ninputs = RAI_ExecutionCtx_NumInputs(&first->base);
+    for (size_t i = 0; i < ninputs; i++) {
+        RAI_Tensor *batch[n];
+        for (size_t b = 0; b < n; b++) {
+            batch[b] = RAI_ExecutionCtx_GetInput(&sctxs[b]->base, i);
+        }
+        RAI_Tensor *input = RAI_TensorCreateByConcatenatingTensors(batch, n);
+        RAI_ExecutionCtx_AddInput(&batched->base, input);
+        RAI_TensorFree(input);
+    }
+    const size_t noutputs = RAI_ExecutionCtx_NumOutputs(&first->base);
+    for (size_t i = 0; i < noutputs; i++) {
+        RAI_ExecutionCtx_AddOutputPlaceholder(&batched->base);
+    }
+
+    int ret = RAI_ScriptRun(batched, err);
+    for (size_t i = 0; i < noutputs && ret == REDISMODULE_OK; i++) {
+        RAI_Tensor *output = RAI_ExecutionCtx_GetOutput(&batched->base, i);
+        if (RAI_TensorNumDims(output) == 0 || RAI_TensorDim(output, 0) != total_batch_size) {
+            RAI_SetError(err, RAI_ESCRIPTRUN,
+                         "ERR Script did not generate the expected batch size");
+            ret = REDISMODULE_ERR;
+            break;
+        }
+        for (size_t b = 0; b < n; b++) {
+            RAI_ExecutionCtx_SetOutput(
+                &sctxs[b]->base,
+                RAI_TensorCreateBySlicingTensor(output, batch_offsets[b], batch_sizes[b]), i);
+        }
+    }
+    RAI_ScriptRunCtxFree(batched);
+    return ret;
+}
+
 int RAI_ScriptRunAsync(RAI_ScriptRunCtx *sctx, RAI_OnFinishCB ScriptAsyncFinish,
                        void *private_data) {
 
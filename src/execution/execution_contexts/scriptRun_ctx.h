@@ -99,6 +99,19 @@ void RAI_ScriptRunCtxFree(RAI_ScriptRunCtx *sctx);
  */
 int RAI_ScriptRun(RAI_ScriptRunCtx *sctx, RAI_Error *err);
 
+/**
+ * Runs a batch of script contexts calling the same (batched) entry point with the same
+ * keys, args and number of outputs in a single script run. The inputs of the contexts are
+ * concatenated along their first dimension, and every output of the run is sliced back
+ * into the corresponding context.
+ *
+ * @param sctxs array of script contexts to run together
+ * @param n number of script contexts
+ * @param err error data structure to store error message in the case of failures
+ * @return REDISMODULE_OK if the script ran successfully, or REDISMODULE_ERR if failed.
+ */
+int RAI_ScriptRunBatched(RAI_ScriptRunCtx **sctxs, size_t n, RAI_Error *err);
+
 /**
  * Insert the ScriptRunCtx to the run queues so it will run asynchronously.
  *
@@ -63,6 +63,8 @@ int RAI_InitRunInfo(RedisAI_RunInfo **result) {
     rinfo->orig_copy = rinfo;
     pthread_rwlock_init(rinfo->dagLock, NULL);
     rinfo->timedOut = RedisModule_Calloc(1, sizeof(int));
+    rinfo->dagWaitingCopies = array_new(RedisAI_RunInfo *, 1);
+    rinfo->dagReadyCopies = array_new(RedisAI_RunInfo *, 1);
 
     *result = rinfo;
     return REDISMODULE_OK;
@@ -74,6 +76,14 @@ int RAI_ShallowCopyDagRunInfo(RedisAI_RunInfo **result, RedisAI_RunInfo *src) {
     memcpy(rinfo, src, sizeof(RedisAI_RunInfo));
 
     rinfo->dagDeviceOps = (RAI_DagOp **)array_new(RAI_DagOp *, 1);
+    rinfo->runQueueItem.value = rinfo;
+    rinfo->runQueueItem.next = NULL;
+    rinfo->runQueueItem.prev = NULL;
+    rinfo->batchingLaneItem.value = rinfo;
+    rinfo->batchingLaneItem.next = NULL;
+    rinfo->batchingLaneItem.prev = NULL;
+    rinfo->batchingLane = NULL;
+    rinfo->batchingSignature = NULL;
     (*rinfo->dagRefCount)++;
     rinfo->dagDeviceOpCount = 0;
     rinfo->dagDeviceCompleteOpCount = 0;
@@ -87,6 +97,9 @@ long long RAI_DagRunInfoFreeShallowCopy(RedisAI_RunInfo *rinfo) {
     if (rinfo->dagDeviceOps) {
         array_free(rinfo->dagDeviceOps);
     }
+    if (rinfo->batchingSignature) {
+        array_free(rinfo->batchingSignature);
+    }
     RedisModule_Free(rinfo);
     return ref_count;
 }
@@ -122,26 +135,28 @@ void RAI_FreeRunInfo(struct RedisAI_RunInfo *rinfo) {
     RedisModule_Free(rinfo->dagRefCount);
     RedisModule_Free(rinfo->dagCompleteOpCount);
     RedisModule_Free(rinfo->timedOut);
+    array_free(rinfo->dagWaitingCopies);
+    array_free(rinfo->dagReadyCopies);
 
     RedisModule_Free(rinfo);
 }
 
 void RAI_ContextReadLock(RedisAI_RunInfo *rinfo) {
-    if (rinfo->single_op_dag || rinfo->single_device_dag) {
+    if (rinfo->single_op_dag || rinfo->single_chain_dag) {
         return;
     }
     pthread_rwlock_rdlock(rinfo->dagLock);
 }
 
 void RAI_ContextWriteLock(RedisAI_RunInfo *rinfo) {
-    if (rinfo->single_op_dag || rinfo->single_device_dag) {
+    if (rinfo->single_op_dag || rinfo->single_chain_dag) {
         return;
     }
     pthread_rwlock_wrlock(rinfo->dagLock);
 }
 
 void RAI_ContextUnlock(RedisAI_RunInfo *rinfo) {
-    if (rinfo->single_op_dag || rinfo->single_device_dag) {
+    if (rinfo->single_op_dag || rinfo->single_chain_dag) {
         return;
     }
     pthread_rwlock_unlock(rinfo->dagLock);
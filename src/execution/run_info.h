@@ -20,12 +20,15 @@
 #include "execution/DAG/dag_op.h"
 #include "util/arr.h"
 #include "util/dict.h"
+#include "util/queue.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 typedef struct RedisAI_RunInfo RedisAI_RunInfo;
+struct RunQueueInfo;
+struct RunQueueBatchingLane;
 
 /**
  * This structure contains the context data at the end of the execution.
@@ -51,12 +54,14 @@ typedef void (*RedisAI_OnFinishCB)(RedisAI_OnFinishCtx *ctx, void *private_data)
 struct RedisAI_RunInfo {
     RedisModuleBlockedClient *client;
     int single_op_dag;
-    int single_device_dag;
+    // All the DAG ops are executed (in order) by a single shallow copy, so no two
+    // ops can run concurrently.
+    int single_chain_dag;
     RAI_Tensor **dagSharedTensors;  // Shared array of tensors that dag ops use.
     AI_dict *persistTensors;        // Associates the tensors to persist with their indices .
     AI_dict *tensorsNamesToIndices; // Maps tensor key name to its (maximal) index.
     RAI_DagOp **dagOps;             // all ops in DAG
-    RAI_DagOp **dagDeviceOps;       // all ops in DAG for device
+    RAI_DagOp **dagDeviceOps;       // all ops in DAG that this copy executes (in order)
     int dagReplyLength;
     int dagOpCount;               // number of ops in DAG
     int *dagCompleteOpCount;      // number of completed ops in DAG
@@ -71,9 +76,32 @@ struct RedisAI_RunInfo {
     pthread_rwlock_t *dagLock;
     // Pointer to ref count in DAG, shared across multiple worker thread
     long long *dagRefCount;
+    // The run queue of the device that this copy runs on.
+    struct RunQueueInfo *runQueue;
+    // The copies whose current op waits for inputs that were not computed yet, and
+    // the copies whose current op became ready but were not pushed to their run
+    // queues yet (see RedisAI_DagWaitForInputs). These are accessed through the
+    // original run info only, while holding the DAG lock.
+    RedisAI_RunInfo **dagWaitingCopies;
+    RedisAI_RunInfo **dagReadyCopies;
     long long timeout;
     int *timedOut;
     struct timeval queuingTime;
+    // The time (in microseconds) in which this copy has entered its run queue for
+    // running its next op, used for the run queue wait time stats.
+    long long queueEnterTime;
+    // Intrusive node that is used for placing this copy in its device's run queue
+    // (a copy resides in a single queue at most).
+    queueItem runQueueItem;
+    // While in the run queue, a copy whose current op is ready and batchable is
+    // also placed (using this intrusive node) in the batching lane of the op's
+    // model and input shapes.
+    queueItem batchingLaneItem;
+    struct RunQueueBatchingLane *batchingLane;
+    // The batching signature of the current op (see RedisAI_DagOpBatchingSignature),
+    // computed once the copy enters a batching lane, and reset when its current op
+    // changes. NULL if it was not computed yet.
+    long long *batchingSignature;
     RedisAI_OnFinishCB OnFinish;
     RedisAI_RunInfo *orig_copy;
     void *private_data; // This is going to be sent to the OnFinish callback.
@@ -105,21 +133,21 @@ void RAI_FreeRunInfo(RedisAI_RunInfo *rinfo);
 
 /**
  * Locks the DAG tensor context rwlock for reads. No-op in case of single
- * op or single device DAGS.
+ * op or single chain DAGS.
  * @param rinfo context in which RedisAI blocking command operate.
  */
 void RAI_ContextReadLock(RedisAI_RunInfo *rinfo);
 
 /**
  * Locks the DAG tensor context rwlock for writes. No-op in case of single
- * op or single device DAGS.
+ * op or single chain DAGS.
  * @param rinfo context in which RedisAI blocking command operate.
  */
 void RAI_ContextWriteLock(RedisAI_RunInfo *rinfo);
 
 /**
  * Unlocks the DAG tensor context rwlock. No-op in case of single op or single
- * device DAGS.
+ * chain DAGS.
  * @param rinfo context in which RedisAI blocking command operate.
  */
 void RAI_ContextUnlock(RedisAI_RunInfo *rinfo);
@@ -4,13 +4,84 @@
  *the Server Side Public License v1 (SSPLv1).
  */
 
+#include <sys/time.h>
 #include "string_utils.h"
 #include "run_queue_info.h"
 #include "backends/backends.h"
 #include "background_workers.h"
+#include "execution/DAG/dag.h"
 
 extern unsigned int BGWorkersCount;
 
+static uint64_t _RunQueue_SignatureHash(const void *key) {
+    return AI_dictGenHashFunction(key, array_len((long long *)key) * sizeof(long long));
+}
+
+static int _RunQueue_SignatureCompare(void *privdata, const void *key1, const void *key2) {
+    long long *signature1 = (long long *)key1;
+    long long *signature2 = (long long *)key2;
+    size_t len = array_len(signature1);
+    return len == array_len(signature2) &&
+           memcmp(signature1, signature2, len * sizeof(long long)) == 0;
+}
+
+// The signature keys are owned by the lanes, that are freed once they get empty.
+static AI_dictType AI_dictTypeBatchingLanes = {
+    .hashFunction = _RunQueue_SignatureHash,
+    .keyDup = NULL,
+    .valDup = NULL,
+    .keyCompare = _RunQueue_SignatureCompare,
+    .keyDestructor = NULL,
+    .valDestructor = NULL,
+};
+
+/**
+ * @brief Returns the batching lane that matches the current op of the given run info,
+ * or NULL if the op is not ready or not batchable. If there is no such lane in the
+ * run queue and create is true, a new lane is created.
+ */
+static RunQueueBatchingLane *_RunQueue_GetBatchingLane(RunQueueInfo *run_queue_info,
+                                                        RedisAI_RunInfo *rinfo, bool create) {
+    if (!RedisAI_DagCurrentOpBatchable(rinfo)) {
+        return NULL;
+    }
+    if (!rinfo->batchingSignature) {
+        rinfo->batchingSignature =
+            RedisAI_DagOpBatchingSignature(rinfo, RedisAI_DagCurrentOp(rinfo));
+    }
+    long long *signature = rinfo->batchingSignature;
+    AI_dictEntry *entry = AI_dictFind(run_queue_info->batching_lanes, signature);
+    if (entry) {
+        return AI_dictGetVal(entry);
+    }
+    if (!create) {
+        return NULL;
+    }
+    // The lane keeps its own copy of the signature, since it may outlive the run
+    // info that created it.
+    size_t len = array_len(signature);
+    RunQueueBatchingLane *lane = RedisModule_Calloc(1, sizeof(RunQueueBatchingLane));
+    lane->signature = array_newlen(long long, len);
+    memcpy(lane->signature, signature, len * sizeof(long long));
+    AI_dictAdd(run_queue_info->batching_lanes, lane->signature, lane);
+    return lane;
+}
+
+static void _RunQueue_RemoveFromBatchingLane(RunQueueInfo *run_queue_info,
+                                             RedisAI_RunInfo *rinfo) {
+    RunQueueBatchingLane *lane = rinfo->batchingLane;
+    if (!lane) {
+        return;
+    }
+    queueEvict(&lane->items, &rinfo->batchingLaneItem);
+    rinfo->batchingLane = NULL;
+    if (queueLength(&lane->items) == 0) {
+        AI_dictDelete(run_queue_info->batching_lanes, lane->signature);
+        array_free(lane->signature);
+        RedisModule_Free(lane);
+    }
+}
+
 RunQueueInfo *RunQueue_Create(const char *device_str) {
 
     size_t device_str_len = strlen(device_str);
@@ -20,7 +91,12 @@ RunQueueInfo *RunQueue_Create(const char *device_str) {
     // Create new run queue and initialize its inner fields.
     RunQueueInfo *run_queue_info = RedisModule_Alloc(sizeof(RunQueueInfo));
     run_queue_info->run_queue = queueCreate();
+    run_queue_info->inbox.head = NULL;
+    run_queue_info->sleeping_workers = 0;
+    run_queue_info->batching_lanes = AI_dictCreate(&AI_dictTypeBatchingLanes, NULL);
+    run_queue_info->pass = 1;
     run_queue_info->device_str = RedisModule_Strdup(upper_device_str);
+    memset(&run_queue_info->stats, 0, sizeof(run_queue_info->stats));
     pthread_cond_init(&(run_queue_info->queue_condition_var), NULL);
     pthread_mutex_init(&(run_queue_info->run_queue_mutex), NULL);
     run_queue_info->threads = array_new(pthread_t, Config_GetNumThreadsPerQueue());
@@ -65,8 +141,150 @@ bool RunQueue_IsExists(const char *device_str) {
     return AI_dictFind(RunQueues, upper_device_str) != NULL;
 }
 
+void RunQueue_Push(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo) {
+    rinfo->queueEnterTime = ustime();
+    __atomic_add_fetch(&run_queue_info->stats.enqueued, 1, __ATOMIC_RELAXED);
+    queueInboxPush(&run_queue_info->inbox, &rinfo->runQueueItem);
+    // Both this load and the inbox push are sequentially consistent, as are the
+    // increment of sleeping_workers and the inbox check in RunQueue_Wait. So,
+    // either the waiting worker sees the new run info, or we see the worker and
+    // signal it (after it has released the mutex in pthread_cond_wait).
+    if (__atomic_load_n(&run_queue_info->sleeping_workers, __ATOMIC_SEQ_CST) > 0) {
+        RunQueue_Notify(run_queue_info);
+    }
+}
+
+void RunQueue_PushBack(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo) {
+    queuePushItem(run_queue_info->run_queue, &rinfo->runQueueItem);
+    rinfo->batchingLane = _RunQueue_GetBatchingLane(run_queue_info, rinfo, true);
+    if (rinfo->batchingLane) {
+        queuePushItem(&rinfo->batchingLane->items, &rinfo->batchingLaneItem);
+    }
+}
+
+void RunQueue_PushFront(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo) {
+    queuePushItemFront(run_queue_info->run_queue, &rinfo->runQueueItem);
+    rinfo->batchingLane = _RunQueue_GetBatchingLane(run_queue_info, rinfo, true);
+    if (rinfo->batchingLane) {
+        queuePushItemFront(&rinfo->batchingLane->items, &rinfo->batchingLaneItem);
+    }
+}
+
+void RunQueue_Evict(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo) {
+    queueEvict(run_queue_info->run_queue, &rinfo->runQueueItem);
+    _RunQueue_RemoveFromBatchingLane(run_queue_info, rinfo);
+}
+
+RedisAI_RunInfo *RunQueue_BatchingLaneNext(RedisAI_RunInfo *rinfo) {
+    queueItem *item = queueNext(&rinfo->batchingLaneItem);
+    return item ? (RedisAI_RunInfo *)item->value : NULL;
+}
+
+void RunQueue_StartPass(RunQueueInfo *run_queue_info) { run_queue_info->pass++; }
+
+void RunQueue_DeferBatchingLane(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo) {
+    if (rinfo->batchingLane) {
+        rinfo->batchingLane->deferredPass = run_queue_info->pass;
+    }
+}
+
+bool RunQueue_IsBatchingLaneDeferred(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo) {
+    return rinfo->batchingLane && rinfo->batchingLane->deferredPass == run_queue_info->pass;
+}
+
+void RunQueue_DrainInbox(RunQueueInfo *run_queue_info) {
+    queue new_items = {0};
+    queueInboxDrain(&run_queue_info->inbox, &new_items);
+    queueItem *item;
+    while ((item = queuePop(&new_items))) {
+        RunQueue_PushBack(run_queue_info, (RedisAI_RunInfo *)item->value);
+    }
+}
+
+void RunQueue_Wait(RunQueueInfo *run_queue_info, const struct timeval *deadline) {
+    __atomic_add_fetch(&run_queue_info->sleeping_workers, 1, __ATOMIC_SEQ_CST);
+    if (queueInboxIsEmpty(&run_queue_info->inbox)) {
+        if (!timerisset(deadline)) {
+            pthread_cond_wait(&run_queue_info->queue_condition_var,
+                              &run_queue_info->run_queue_mutex);
+        } else {
+            struct timespec absTimeout;
+            absTimeout.tv_sec = deadline->tv_sec;
+            absTimeout.tv_nsec = deadline->tv_usec * 1000;
+            pthread_cond_timedwait(&run_queue_info->queue_condition_var,
+                                   &run_queue_info->run_queue_mutex, &absTimeout);
+        }
+    }
+    __atomic_sub_fetch(&run_queue_info->sleeping_workers, 1, __ATOMIC_SEQ_CST);
+}
+
+void RunQueue_Notify(RunQueueInfo *run_queue_info) {
+    pthread_mutex_lock(&run_queue_info->run_queue_mutex);
+    pthread_cond_signal(&run_queue_info->queue_condition_var);
+    pthread_mutex_unlock(&run_queue_info->run_queue_mutex);
+}
+
+void RunQueue_Reinsert(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo) {
+    rinfo->queueEnterTime = ustime();
+    __atomic_add_fetch(&run_queue_info->stats.enqueued, 1, __ATOMIC_RELAXED);
+    RunQueue_PushFront(run_queue_info, rinfo);
+}
+
+void RunQueue_RecordDequeue(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo) {
+    RunQueueStats *stats = &run_queue_info->stats;
+    long long wait = ustime() - rinfo->queueEnterTime;
+    unsigned long long wait_us = wait > 0 ? wait : 0;
+    __atomic_add_fetch(&stats->dequeued, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats->total_wait_us, wait_us, __ATOMIC_RELAXED);
+    unsigned long long max_wait = __atomic_load_n(&stats->max_wait_us, __ATOMIC_RELAXED);
+    while (wait_us > max_wait &&
+           !__atomic_compare_exchange_n(&stats->max_wait_us, &max_wait, wait_us, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+void RunQueue_RecordBusyTime(RunQueueInfo *run_queue_info, long long busy_us) {
+    if (busy_us > 0) {
+        __atomic_add_fetch(&run_queue_info->stats.busy_us, busy_us, __ATOMIC_RELAXED);
+    }
+}
+
+void RunQueue_RecordBatch(RunQueueInfo *run_queue_info, size_t size, size_t batchsize) {
+    if (batchsize == 0) {
+        return;
+    }
+    size_t fill = size >= batchsize ? 1000 : size * 1000 / batchsize;
+    __atomic_add_fetch(&run_queue_info->stats.batches, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&run_queue_info->stats.batch_fill, fill, __ATOMIC_RELAXED);
+}
+
+void RunQueue_GetStatsReport(RunQueueInfo *run_queue_info, RunQueueStatsReport *report) {
+    RunQueueStats *stats = &run_queue_info->stats;
+    unsigned long long dequeued = __atomic_load_n(&stats->dequeued, __ATOMIC_RELAXED);
+    unsigned long long enqueued = __atomic_load_n(&stats->enqueued, __ATOMIC_RELAXED);
+    unsigned long long batches = __atomic_load_n(&stats->batches, __ATOMIC_RELAXED);
+    unsigned long long total_wait_us = __atomic_load_n(&stats->total_wait_us, __ATOMIC_RELAXED);
+
+    // The counters are not read atomically together, so a run info that was just
+    // dequeued might not be counted as enqueued yet.
+    report->depth = enqueued > dequeued ? enqueued - dequeued : 0;
+    report->enqueued = enqueued;
+    report->dequeued = dequeued;
+    report->avg_wait_us = dequeued > 0 ? (double)total_wait_us / dequeued : 0;
+    report->max_wait_us = __atomic_load_n(&stats->max_wait_us, __ATOMIC_RELAXED);
+    report->busy_us = __atomic_load_n(&stats->busy_us, __ATOMIC_RELAXED);
+    report->batches = batches;
+    report->avg_batch_fill =
+        batches > 0
+            ? (double)__atomic_load_n(&stats->batch_fill, __ATOMIC_RELAXED) / batches / 1000
+            : 0;
+}
+
 void RunQueue_Free(RunQueueInfo *run_queue_info) {
     RedisModule_Assert(queueLength(run_queue_info->run_queue) == 0);
+    RedisModule_Assert(queueInboxIsEmpty(&run_queue_info->inbox));
+    RedisModule_Assert(AI_dictSize(run_queue_info->batching_lanes) == 0);
+    AI_dictRelease(run_queue_info->batching_lanes);
     RedisModule_Free(run_queue_info->run_queue);
     RedisModule_Free(run_queue_info->device_str);
 
@@ -15,16 +15,78 @@
 
 #include "utils.h"
 #include "queue.h"
+#include "run_info.h"
 #include "dictionaries.h"
 
 AI_dict *RunQueues;
 
+/**
+ * The run infos in a run queue whose current op is ready and batchable, and that
+ * share the same batching signature (see RedisAI_DagOpBatchingSignature), in the
+ * order in which they appear in the run queue.
+ */
+typedef struct RunQueueBatchingLane {
+    queue items;
+    long long *signature;
+    // The pass over the run queue in which the batch of this lane was found not
+    // ready (see RunQueue_DeferBatchingLane).
+    unsigned long long deferredPass;
+} RunQueueBatchingLane;
+
+/**
+ * Counters that describe the load of a run queue. They are updated (atomically) by
+ * the workers and by the threads that push run infos to the queue, and reported in
+ * the "queues" section of INFO.
+ */
+typedef struct RunQueueStats {
+    // Number of run infos that entered the queue, including DAG run infos that
+    // re-enter it for running their next op.
+    unsigned long long enqueued;
+    // Number of run infos that were taken from the queue for execution.
+    unsigned long long dequeued;
+    unsigned long long total_wait_us;
+    unsigned long long max_wait_us;
+    // Total time that the workers spent executing (rather than waiting).
+    unsigned long long busy_us;
+    // Number of model runs that were formed for models with BATCHSIZE, and the sum
+    // of their fill ratio (the batch size relative to BATCHSIZE) in thousandths.
+    unsigned long long batches;
+    unsigned long long batch_fill;
+} RunQueueStats;
+
+/**
+ * The metrics of a run queue, as computed by RunQueue_GetStatsReport. The counters are
+ * cumulative, so that a monitoring client computes rates (and the fraction of time in
+ * which the workers were busy) from the differences between two reports.
+ */
+typedef struct RunQueueStatsReport {
+    unsigned long long depth;
+    unsigned long long enqueued;
+    unsigned long long dequeued;
+    double avg_wait_us;
+    unsigned long long max_wait_us;
+    unsigned long long busy_us;
+    unsigned long long batches;
+    double avg_batch_fill;
+} RunQueueStatsReport;
+
 typedef struct RunQueueInfo {
     pthread_mutex_t run_queue_mutex;
     pthread_cond_t queue_condition_var;
     queue *run_queue;
+    // New run infos are pushed here without locking the run queue mutex, and are
+    // moved to the run queue by the workers.
+    queueInbox inbox;
+    // Number of workers that are currently waiting for a signal (or a deadline).
+    unsigned int sleeping_workers;
+    // Maps a batching signature to its RunQueueBatchingLane, so that collecting
+    // the run infos that can be batched together doesn't require a queue scan.
+    AI_dict *batching_lanes;
+    // The current pass of the workers over the run queue (see RunQueue_StartPass).
+    unsigned long long pass;
     pthread_t *threads;
     char *device_str;
+    RunQueueStats stats;
 } RunQueueInfo;
 
 /**
@@ -43,6 +105,108 @@ bool RunQueue_IsExists(const char *device_str);
  */
 RunQueueInfo *RunQueue_GetInfo(const char *device_str);
 
+/**
+ * @brief Push a run info to the run queue of a device. This is lock-free and does not
+ * allocate, a worker is signaled (under the run queue mutex) only if any of them is
+ * waiting.
+ */
+void RunQueue_Push(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo);
+
+/**
+ * @brief Push a run info to the back of the run queue (and to the back of its
+ * batching lane, if its current op is ready and batchable). Must be called while
+ * holding the run queue mutex.
+ */
+void RunQueue_PushBack(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo);
+
+/**
+ * @brief Push a run info to the front of the run queue (and to the front of its
+ * batching lane, if its current op is ready and batchable). Must be called while
+ * holding the run queue mutex.
+ */
+void RunQueue_PushFront(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo);
+
+/**
+ * @brief Remove a run info from the run queue (wherever it is). Must be called
+ * while holding the run queue mutex.
+ */
+void RunQueue_Evict(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo);
+
+/**
+ * @brief Returns the run info that follows the given one in its batching lane, or
+ * NULL if there is none.
+ */
+RedisAI_RunInfo *RunQueue_BatchingLaneNext(RedisAI_RunInfo *rinfo);
+
+/**
+ * @brief Start a new pass over the run queue. Batching lanes that were deferred in
+ * previous passes are examined again. Must be called while holding the run queue
+ * mutex.
+ */
+void RunQueue_StartPass(RunQueueInfo *run_queue_info);
+
+/**
+ * @brief Mark the batching lane of the given run info as deferred for the current
+ * pass, since its batch is not ready. The run infos of the lane stay in place.
+ * Must be called while holding the run queue mutex.
+ */
+void RunQueue_DeferBatchingLane(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo);
+
+/**
+ * @brief Returns true if the batching lane of the given run info was deferred in
+ * the current pass. Must be called while holding the run queue mutex.
+ */
+bool RunQueue_IsBatchingLaneDeferred(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo);
+
+/**
+ * @brief Move the run infos that were pushed since the last call to the back of the
+ * run queue. Must be called while holding the run queue mutex.
+ */
+void RunQueue_DrainInbox(RunQueueInfo *run_queue_info);
+
+/**
+ * @brief Wait on the run queue condition variable until the run queue is signaled or
+ * the given deadline (if set) is reached. Must be called while holding the run
+ * queue mutex. Returns immediately if there are run infos in the inbox.
+ */
+void RunQueue_Wait(RunQueueInfo *run_queue_info, const struct timeval *deadline);
+
+/**
+ * @brief Wake up a worker of the given run queue, so that it will re-examine the
+ * run infos that are pending in the queue.
+ */
+void RunQueue_Notify(RunQueueInfo *run_queue_info);
+
+/**
+ * @brief Record that a run info, whose current op was already executed, re-enters
+ * the run queue for running its next op. Must be called while holding the run queue
+ * mutex.
+ */
+void RunQueue_Reinsert(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo);
+
+/**
+ * @brief Record in the run queue stats that a run info was taken from the queue for
+ * execution.
+ */
+void RunQueue_RecordDequeue(RunQueueInfo *run_queue_info, RedisAI_RunInfo *rinfo);
+
+/**
+ * @brief Record in the run queue stats that a worker was busy executing for busy_us.
+ */
+void RunQueue_RecordBusyTime(RunQueueInfo *run_queue_info, long long busy_us);
+
+/**
+ * @brief Record in the run queue stats that a batch of the given size was formed for a
+ * model whose maximal batch size is batchsize.
+ */
+void RunQueue_RecordBatch(RunQueueInfo *run_queue_info, size_t size, size_t batchsize);
+
+/**
+ * @brief Compute the current metrics of a run queue. This does not change the queue's
+ * stats, so it may be called from any thread.
+ */
+void RunQueue_GetStatsReport(RunQueueInfo *run_queue_info, RunQueueStatsReport *report);
+
 /**
  * @brief Terminate all working threads and free the run queue with its inner fields.
  */
@@ -28,6 +28,30 @@
 
 extern RedisModuleType *RedisAI_ModelType;
 
+// Number of models in the RAI_MODEL_LOAD_FAILED state that were not freed yet.
+static unsigned long long ModelsLoadFailed = 0;
+
+static void _RAI_ModelFreeBatchBuffers(RAI_Tensor **buffers) {
+    for (size_t i = 0; i < array_len(buffers); i++) {
+        RAI_TensorFree(buffers[i]);
+    }
+    array_free(buffers);
+}
+
+// Frees the definition that a model which was not built by a backend holds.
+static void _RAI_ModelFreeDefinition(RAI_Model *model) {
+    RedisModule_Free(model->devicestr);
+    for (size_t i = 0; i < model->ninputs; i++) {
+        RedisModule_Free(model->inputs[i]);
+    }
+    RedisModule_Free(model->inputs);
+    for (size_t i = 0; i < model->noutputs; i++) {
+        RedisModule_Free(model->outputs[i]);
+    }
+    RedisModule_Free(model->outputs);
+    RedisModule_Free(model->data);
+}
+
 RAI_Model *RAI_ModelCreate(RAI_Backend backend, const char *devicestr, RedisModuleString *tag,
                            RAI_ModelOpts opts, size_t ninputs, const char **inputs, size_t noutputs,
                            const char **outputs, const char *modeldef, size_t modellen,
@@ -69,17 +93,76 @@ RAI_Model *RAI_ModelCreate(RAI_Backend backend, const char *devicestr, RedisModu
         } else {
             model->tag = RedisModule_CreateString(NULL, "", 0);
         }
+        if (opts.batchsize > 0 && opts.latencytarget > 0) {
+            model->batching = RAI_BatchingProfileCreate(opts.batchsize, opts.latencytarget);
+        }
     }
 
     return model;
 }
 
+RAI_Model *RAI_ModelCreatePending(RAI_Backend backend, const char *devicestr,
+                                  RedisModuleString *tag, RAI_ModelOpts opts, size_t ninputs,
+                                  const char **inputs, size_t noutputs, const char **outputs,
+                                  char *modeldef, size_t modellen) {
+    RAI_Model *model = RedisModule_Calloc(1, sizeof(*model));
+    model->backend = backend;
+    model->devicestr = RedisModule_Strdup(devicestr);
+    model->tag = tag ? RAI_HoldString(tag) : RedisModule_CreateString(NULL, "", 0);
+    model->opts = opts;
+    model->ninputs = ninputs;
+    model->inputs = RedisModule_Alloc(ninputs * sizeof(char *));
+    for (size_t i = 0; i < ninputs; i++) {
+        model->inputs[i] = RedisModule_Strdup(inputs[i]);
+    }
+    model->noutputs = noutputs;
+    model->outputs = RedisModule_Alloc(noutputs * sizeof(char *));
+    for (size_t i = 0; i < noutputs; i++) {
+        model->outputs[i] = RedisModule_Strdup(outputs[i]);
+    }
+    model->data = modeldef;
+    model->datalen = modellen;
+    model->refCount = 1;
+    model->state = RAI_MODEL_LOADING;
+    return model;
+}
+
+void RAI_ModelCompleteLoading(RAI_Model *model, RAI_Model *loaded) {
+    if (!loaded) {
+        model->state = RAI_MODEL_LOAD_FAILED;
+        __atomic_add_fetch(&ModelsLoadFailed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    // Move the backend model into the pending one, which is the one that the keyspace holds.
+    _RAI_ModelFreeDefinition(model);
+    model->model = loaded->model;
+    model->session = loaded->session;
+    model->devicestr = loaded->devicestr;
+    model->inputs = loaded->inputs;
+    model->ninputs = loaded->ninputs;
+    model->outputs = loaded->outputs;
+    model->noutputs = loaded->noutputs;
+    model->data = loaded->data;
+    model->datalen = loaded->datalen;
+    model->batching = loaded->batching;
+    model->state = RAI_MODEL_READY;
+
+    RedisModule_FreeString(NULL, loaded->tag);
+    RedisModule_Free(loaded);
+}
+
 void RAI_ModelFree(RAI_Model *model, RAI_Error *err) {
     if (__atomic_sub_fetch(&model->refCount, 1, __ATOMIC_RELAXED) > 0) {
         return;
     }
 
-    if (model->backend == RAI_BACKEND_TENSORFLOW) {
+    if (model->state != RAI_MODEL_READY) {
+        if (model->state == RAI_MODEL_LOAD_FAILED) {
+            __atomic_sub_fetch(&ModelsLoadFailed, 1, __ATOMIC_RELAXED);
+        }
+        _RAI_ModelFreeDefinition(model);
+    } else if (model->backend == RAI_BACKEND_TENSORFLOW) {
         if (!RAI_backends.tf.model_free) {
             RAI_SetError(err, RAI_EBACKENDNOTLOADED, "ERR Backend not loaded: TF");
             return;
@@ -109,6 +192,12 @@ void RAI_ModelFree(RAI_Model *model, RAI_Error *err) {
     }
 
     RedisModule_FreeString(NULL, model->tag);
+    if (model->batchBuffers) {
+        _RAI_ModelFreeBatchBuffers(model->batchBuffers);
+    }
+    if (model->batching) {
+        RAI_BatchingProfileFree(model->batching);
+    }
 
     // If the run stats which is stored under this key is the same one that the model holds a
     // reference to, remove the entry from the global statistics dictionary as well. Otherwise,
@@ -167,6 +256,17 @@ int RAI_ModelSerialize(RAI_Model *model, char **buffer, size_t *len, RAI_Error *
     return ret;
 }
 
+int RAI_ModelGetBlob(RAI_Model *model, char **buffer, size_t *len, bool *owned, RAI_Error *err) {
+    if (model->data) {
+        *buffer = model->data;
+        *len = model->datalen;
+        *owned = false;
+        return REDISMODULE_OK;
+    }
+    *owned = true;
+    return RAI_ModelSerialize(model, buffer, len, err);
+}
+
 int RedisAI_ModelRun_IsKeysPositionRequest_ReportKeys(RedisModuleCtx *ctx, RedisModuleString **argv,
                                                       int argc) {
     RedisModule_KeyAtPos(ctx, 1);
@@ -256,9 +356,25 @@ int RAI_GetModelFromKeyspace(RedisModuleCtx *ctx, RedisModuleString *keyName, RA
     }
     *model = RedisModule_ModuleTypeGetValue(key);
     RedisModule_CloseKey(key);
+
+    // A model which is not built yet can only be opened for writing (so that it can be deleted or
+    // overwritten), but not for running it.
+    if (!(mode & REDISMODULE_WRITE) && (*model)->state != RAI_MODEL_READY) {
+        if ((*model)->state == RAI_MODEL_LOADING) {
+            RAI_SetError(err, RAI_EMODELRUN, "LOADING Model is being loaded");
+        } else {
+            RAI_SetError(err, RAI_EMODELRUN,
+                         "ERR Model could not be loaded, see the server log for details");
+        }
+        return REDISMODULE_ERR;
+    }
     return REDISMODULE_OK;
 }
 
+unsigned long long RAI_ModelGetLoadFailedCount(void) {
+    return __atomic_load_n(&ModelsLoadFailed, __ATOMIC_RELAXED);
+}
+
 inline size_t RAI_ModelGetNumInputs(RAI_Model *model) { return model->ninputs; }
 
 inline size_t RAI_ModelGetNumOutputs(RAI_Model *model) { return model->noutputs; }
@@ -273,4 +389,27 @@ inline void *RAI_ModelGetSession(RAI_Model *model) { return model->session; }
 
 inline void *RAI_ModelGetModel(RAI_Model *model) { return model->model; }
 
+RAI_Tensor **RAI_ModelAcquireBatchBuffers(RAI_Model *model, size_t ninputs) {
+    RAI_Tensor **buffers = __atomic_exchange_n(&model->batchBuffers, NULL, __ATOMIC_ACQ_REL);
+    if (buffers && array_len(buffers) == ninputs) {
+        return buffers;
+    }
+    if (buffers) {
+        _RAI_ModelFreeBatchBuffers(buffers);
+    }
+    buffers = array_new(RAI_Tensor *, ninputs);
+    for (size_t i = 0; i < ninputs; i++) {
+        buffers = array_append(buffers, NULL);
+    }
+    return buffers;
+}
+
+void RAI_ModelReleaseBatchBuffers(RAI_Model *model, RAI_Tensor **buffers) {
+    RAI_Tensor **expected = NULL;
+    if (!__atomic_compare_exchange_n(&model->batchBuffers, &expected, buffers, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        _RAI_ModelFreeBatchBuffers(buffers);
+    }
+}
+
 RedisModuleType *RAI_ModelRedisType(void) { return RedisAI_ModelType; }
@@ -48,6 +48,34 @@ RAI_Model *RAI_ModelCreate(RAI_Backend backend, const char *devicestr, RedisModu
                            const char **outputs, const char *modeldef, size_t modellen,
                            RAI_Error *err);
 
+/**
+ * Allocates a RAI_Model in the RAI_MODEL_LOADING state, which holds the model
+ * definition but no backend model yet. It is used when loading from RDB, so that
+ * the backend model can be built in the background (see model_loader.h), and is
+ * completed with RAI_ModelCompleteLoading. Until then, the model can be
+ * persisted, but not run.
+ *
+ * @param modeldef encoded model definition, which the model takes ownership of
+ * @param modellen length of the encoded model definition
+ * The rest of the params are as in RAI_ModelCreate.
+ * @return RAI_Model model structure in the RAI_MODEL_LOADING state
+ */
+RAI_Model *RAI_ModelCreatePending(RAI_Backend backend, const char *devicestr,
+                                  RedisModuleString *tag, RAI_ModelOpts opts, size_t ninputs,
+                                  const char **inputs, size_t noutputs, const char **outputs,
+                                  char *modeldef, size_t modellen);
+
+/**
+ * Completes the loading of a model created by RAI_ModelCreatePending, by moving
+ * the backend model into it. Must be called from the main thread.
+ *
+ * @param model model in the RAI_MODEL_LOADING state
+ * @param loaded the model that RAI_ModelCreate built from the definition of
+ * `model` (freed by this function), or NULL if the backend failed to build it,
+ * in which case `model` moves to the RAI_MODEL_LOAD_FAILED state.
+ */
+void RAI_ModelCompleteLoading(RAI_Model *model, RAI_Model *loaded);
+
 /**
  * Frees the memory of the RAI_Model when the model reference count reaches
  * 0. It is safe to call this function with a NULL input model.
@@ -58,6 +86,13 @@ RAI_Model *RAI_ModelCreate(RAI_Backend backend, const char *devicestr, RedisModu
  */
 void RAI_ModelFree(RAI_Model *model, RAI_Error *err);
 
+/**
+ * Returns the number of models that were decoded from RDB but could not be
+ * built by their backend (see RAI_ModelCompleteLoading), and that were not
+ * deleted or overwritten since.
+ */
+unsigned long long RAI_ModelGetLoadFailedCount(void);
+
 /**
  * Every call to this function, will make the RAI_Model 'model' requiring an
  * additional call to RAI_ModelFree() in order to really free the model.
@@ -82,6 +117,23 @@ RAI_Model *RAI_ModelGetShallowCopy(RAI_Model *model);
  * */
 int RAI_ModelSerialize(RAI_Model *model, char **buffer, size_t *len, RAI_Error *err);
 
+/**
+ * Returns the serialized model in `buffer`, for persisting or replying it. Unlike
+ * RAI_ModelSerialize, if the model keeps its definition (as the TFLITE, TORCH
+ * and ONNX backends do), the buffer points to it rather than to a copy, and must
+ * not be modified or freed. Otherwise, the backend serializes the model into a
+ * new buffer that the caller owns.
+ *
+ * @param model RAI_Model pointer
+ * @param buffer pointer to the output buffer
+ * @param len pointer to the variable to save the output buffer length
+ * @param owned set to true if the caller has to free the buffer
+ * @param error error data structure to store error message in the case of
+ * failures
+ * @return REDISMODULE_OK on success, or REDISMODULE_ERR if the serialization failed.
+ * */
+int RAI_ModelGetBlob(RAI_Model *model, char **buffer, size_t *len, bool *owned, RAI_Error *err);
+
 /**
  * Helper method to get a Model from keyspace. In the case of failure the key is
  * closed and the error is replied ( no cleaning actions required )
@@ -89,7 +141,8 @@ int RAI_ModelSerialize(RAI_Model *model, char **buffer, size_t *len, RAI_Error *
  * @param ctx Context in which Redis modules operate
  * @param keyName key name
  * @param model destination model structure
- * @param mode key access mode
+ * @param mode key access mode. Unless REDISMODULE_WRITE is set, a model which
+ * is not RAI_MODEL_READY (see RAI_ModelCreatePending) is reported as an error.
  * @param error contains the error in case of problem with retrival
  * @return REDISMODULE_OK if the model value stored at key was correctly
  * returned and available at *model variable, or REDISMODULE_ERR if there was
@@ -150,6 +203,21 @@ void *RAI_ModelGetSession(RAI_Model *model);
  */
 void *RAI_ModelGetModel(RAI_Model *model);
 
+/**
+ * @brief Take the model's reusable batch tensors (one place holder per input), to be used with
+ * RAI_TensorConcatenateIntoBatch in batched runs. If another run is currently using them, a set
+ * of empty place holders is returned. The caller must give the batch tensors back with
+ * RAI_ModelReleaseBatchBuffers once the run is done.
+ */
+RAI_Tensor **RAI_ModelAcquireBatchBuffers(RAI_Model *model, size_t ninputs);
+
+/**
+ * @brief Give back batch tensors that were taken with RAI_ModelAcquireBatchBuffers, so the
+ * next batched run of the model can reuse them. If the model already holds another set of batch
+ * tensors, the given ones are freed.
+ */
+void RAI_ModelReleaseBatchBuffers(RAI_Model *model, RAI_Tensor **buffers);
+
 /**
  * @brief  Returns the redis module type representing a model.
  * @return redis module type representing a model.
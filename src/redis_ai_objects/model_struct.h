@@ -9,17 +9,25 @@
 #include "config/config.h"
 #include "tensor_struct.h"
 #include "redis_ai_objects/stats.h"
+#include "execution/adaptive_batching.h"
 
 typedef struct RAI_ModelOpts {
     size_t batchsize;
     size_t minbatchsize;
     size_t minbatchtimeout;
+    size_t latencytarget; // p99 latency target in msec, enables adaptive batching when set.
     long long backends_intra_op_parallelism; //  number of threads used within an
     //  individual op for parallelism.
     long long backends_inter_op_parallelism; //  number of threads used for parallelism
                                              //  between independent operations.
 } RAI_ModelOpts;
 
+typedef enum RAI_ModelState {
+    RAI_MODEL_READY = 0,   // The backend model is built and can be executed.
+    RAI_MODEL_LOADING,     // Decoded from RDB, the backend model is being built in the background.
+    RAI_MODEL_LOAD_FAILED, // Decoded from RDB, but the backend could not build the model.
+} RAI_ModelState;
+
 typedef struct RAI_Model {
     void *model;
     // TODO: use session pool? The ideal would be to use one session per client.
@@ -38,4 +46,8 @@ typedef struct RAI_Model {
     char *data;
     long long datalen;
     RAI_RunStats *info;
+    RAI_Tensor **batchBuffers; // Reusable batch tensors (one per input) for batched runs.
+    RAI_BatchingProfile *batching; // Latency profile for adaptive batching (LATENCYTARGET).
+    RAI_ModelState state; // Until the model is READY, it only holds its definition (no backend
+                          // model or session).
 } RAI_Model;
@@ -27,7 +27,8 @@
 extern RedisModuleType *RedisAI_ScriptType;
 
 RAI_Script *RAI_ScriptCompile(const char *devicestr, RedisModuleString *tag, const char *scriptdef,
-                              const char **entryPoints, size_t nEntryPoints, RAI_Error *err) {
+                              const char **entryPoints, size_t nEntryPoints,
+                              const RAI_ScriptBatchOpts *batchOpts, RAI_Error *err) {
     if (!RAI_backends.torch.script_create) {
         RAI_SetError(err, RAI_EBACKENDNOTLOADED, "ERR Backend not loaded: TORCH");
         return NULL;
@@ -41,6 +42,13 @@ RAI_Script *RAI_ScriptCompile(const char *devicestr, RedisModuleString *tag, con
         } else {
             script->tag = RedisModule_CreateString(NULL, "", 0);
         }
+        for (size_t i = 0; batchOpts && i < nEntryPoints; i++) {
+            if (batchOpts[i].batchsize > 0) {
+                script->batchOpts = RedisModule_Alloc(nEntryPoints * sizeof(*batchOpts));
+                memcpy(script->batchOpts, batchOpts, nEntryPoints * sizeof(*batchOpts));
+                break;
+            }
+        }
     }
 
     return script;
@@ -48,7 +56,7 @@ RAI_Script *RAI_ScriptCompile(const char *devicestr, RedisModuleString *tag, con
 
 RAI_Script *RAI_ScriptCreate(const char *devicestr, RedisModuleString *tag, const char *scriptdef,
                              RAI_Error *err) {
-    return RAI_ScriptCompile(devicestr, tag, scriptdef, NULL, 0, err);
+    return RAI_ScriptCompile(devicestr, tag, scriptdef, NULL, 0, NULL, err);
 }
 
 void RAI_ScriptFree(RAI_Script *script, RAI_Error *err) {
@@ -62,6 +70,7 @@ void RAI_ScriptFree(RAI_Script *script, RAI_Error *err) {
     }
 
     RedisModule_FreeString(NULL, script->tag);
+    RedisModule_Free(script->batchOpts);
 
     // If the run stats which is stored under this key is the same one that the script holds a
     // reference to, remove the entry from the global statistics dictionary as well. Otherwise,
@@ -75,6 +84,18 @@ void RAI_ScriptFree(RAI_Script *script, RAI_Error *err) {
     RAI_backends.torch.script_free(script, err);
 }
 
+const RAI_ScriptBatchOpts *RAI_ScriptGetBatchOpts(RAI_Script *script, const char *fnname) {
+    if (!script->batchOpts) {
+        return NULL;
+    }
+    for (size_t i = 0; i < array_len(script->entryPoints); i++) {
+        if (strcmp(fnname, script->entryPoints[i]) == 0) {
+            return script->batchOpts[i].batchsize > 0 ? &script->batchOpts[i] : NULL;
+        }
+    }
+    return NULL;
+}
+
 RAI_Script *RAI_ScriptGetShallowCopy(RAI_Script *script) {
     __atomic_fetch_add(&script->refCount, 1, __ATOMIC_RELAXED);
     return script;
@@ -42,12 +42,21 @@ RAI_Script *RAI_ScriptCreate(const char *devicestr, RedisModuleString *tag, cons
  * @param scriptdef encoded script definition
  * @param entryPoints array of entry point function names
  * @param nEntryPoints number of entry points
+ * @param batchOpts optional array of batching options, one per entry point
  * @param err error data structure to store error message in the case of
  * failures
  * @return RAI_Script*
  */
 RAI_Script *RAI_ScriptCompile(const char *devicestr, RedisModuleString *tag, const char *scriptdef,
-                              const char **entryPoints, size_t nEntryPoints, RAI_Error *err);
+                              const char **entryPoints, size_t nEntryPoints,
+                              const RAI_ScriptBatchOpts *batchOpts, RAI_Error *err);
+
+/**
+ * @brief Returns the batching options of a script function, or NULL if calls to
+ * the function are not batched (the function is not an entry point which was
+ * stored with BATCHSIZE).
+ */
+const RAI_ScriptBatchOpts *RAI_ScriptGetBatchOpts(RAI_Script *script, const char *fnname);
 
 /**
  * Frees the memory of the RAI_Script when the script reference count reaches
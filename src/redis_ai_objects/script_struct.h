@@ -23,6 +23,12 @@ typedef enum {
     STRING_LIST
 } TorchScriptFunctionArgumentType;
 
+typedef struct RAI_ScriptBatchOpts {
+    size_t batchsize;       // Calls to the entry point are batched if set.
+    size_t minbatchsize;    // Minimal size of a batch (optional).
+    size_t minbatchtimeout; // Timeout (msec) for reaching minbatchsize (optional).
+} RAI_ScriptBatchOpts;
+
 typedef struct RAI_Script {
     void *script;
     char *scriptdef;
@@ -35,4 +41,5 @@ typedef struct RAI_Script {
     long long refCount;
     RAI_RunStats *info;
     char **entryPoints;
+    RAI_ScriptBatchOpts *batchOpts; // Batching options per entry point (NULL if none is batched).
 } RAI_Script;
@@ -21,6 +21,9 @@
 // Global dictionary that stores run statistics for all models and scripts in the shard.
 AI_dict *RunStats;
 
+const double RAI_StatsPercentiles[RAI_STATS_NUM_PERCENTILES] = {50, 90, 99, 99.9};
+const char *RAI_StatsPercentileNames[RAI_STATS_NUM_PERCENTILES] = {"p50", "p90", "p99", "p999"};
+
 long long ustime(void) {
     struct timeval tv;
     long long ust;
@@ -50,6 +53,9 @@ void RAI_StatsReset(RAI_RunStats *r_stats) {
     __atomic_store_n(&r_stats->samples, 0, __ATOMIC_RELAXED);
     __atomic_store_n(&r_stats->calls, 0, __ATOMIC_RELAXED);
     __atomic_store_n(&r_stats->n_errors, 0, __ATOMIC_RELAXED);
+    RAI_HistogramReset(&r_stats->exec_latency);
+    RAI_HistogramReset(&r_stats->queue_latency);
+    RAI_HistogramReset(&r_stats->total_latency);
 }
 
 void RAI_StatsAddDataPoint(RAI_RunStats *r_stats, unsigned long duration, unsigned long calls,
@@ -61,6 +67,14 @@ void RAI_StatsAddDataPoint(RAI_RunStats *r_stats, unsigned long duration, unsign
     __atomic_add_fetch(&r_stats->samples, samples, __ATOMIC_RELAXED);
 }
 
+void RAI_StatsAddLatencies(RAI_RunStats *r_stats, long long exec_us, long long queue_us,
+                           long long total_us) {
+    RedisModule_Assert(r_stats);
+    RAI_HistogramRecord(&r_stats->exec_latency, exec_us > 0 ? exec_us : 0);
+    RAI_HistogramRecord(&r_stats->queue_latency, queue_us > 0 ? queue_us : 0);
+    RAI_HistogramRecord(&r_stats->total_latency, total_us > 0 ? total_us : 0);
+}
+
 void RAI_StatsFree(RAI_RunStats *r_stats) {
     if (r_stats) {
         if (r_stats->device_str) {
@@ -72,6 +86,9 @@ void RAI_StatsFree(RAI_RunStats *r_stats) {
         if (r_stats->key) {
             RedisModule_FreeString(NULL, r_stats->key);
         }
+        RAI_HistogramFree(&r_stats->exec_latency);
+        RAI_HistogramFree(&r_stats->queue_latency);
+        RAI_HistogramFree(&r_stats->total_latency);
         RedisModule_Free(r_stats);
     }
 }
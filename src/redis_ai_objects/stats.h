@@ -18,6 +18,7 @@
 #include "config/config.h"
 #include "redismodule.h"
 #include "util/dict.h"
+#include "util/histogram.h"
 
 typedef struct RAI_RunStats {
     RedisModuleString *key;
@@ -30,8 +31,16 @@ typedef struct RAI_RunStats {
     unsigned long calls;
     unsigned long n_errors;
     unsigned long ref_count;
+    RAI_Histogram exec_latency;  // Execution time of every successful call (us).
+    RAI_Histogram queue_latency; // Time from enqueuing until the execution started (us).
+    RAI_Histogram total_latency; // Time from enqueuing until the request completed (us).
 } RAI_RunStats;
 
+// The percentiles that are reported for the latency histograms.
+#define RAI_STATS_NUM_PERCENTILES 4
+extern const double RAI_StatsPercentiles[RAI_STATS_NUM_PERCENTILES];
+extern const char *RAI_StatsPercentileNames[RAI_STATS_NUM_PERCENTILES];
+
 long long ustime(void);
 mstime_t mstime(void);
 
@@ -67,6 +76,16 @@ void RAI_StatsReset(RAI_RunStats *run_stats);
 void RAI_StatsAddDataPoint(RAI_RunStats *r_stats, unsigned long duration, unsigned long calls,
                            unsigned long errors, unsigned long samples);
 
+/**
+ * Record the latencies of a successful execution in the latency histograms.
+ * @param r_stats runStats entry that matches some model/script.
+ * @param exec_us execution runtime in us
+ * @param queue_us time that passed from enqueuing until the execution started in us
+ * @param total_us time that passed from enqueuing until the request completed in us
+ */
+void RAI_StatsAddLatencies(RAI_RunStats *r_stats, long long exec_us, long long queue_us,
+                           long long total_us);
+
 /**
  * @brief Release RunStats struct.
  * @param run_stats entry to remove.
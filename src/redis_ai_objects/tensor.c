@@ -55,6 +55,62 @@ static bool _ValOverflow(long long val, RAI_Tensor *t) {
     return false;
 }
 
+// Batch tensors blobs are aligned to this number of bytes.
+#define BATCH_BLOB_ALIGNMENT 64
+
+// A batch tensor blob is an over-allocated chunk whose aligned part holds the tensor data. The
+// chunk and its capacity are kept as the managed tensor context, so that subsequent batches which
+// fit into the chunk can reuse it.
+typedef struct RAI_TensorBatchBlob {
+    void *chunk;
+    size_t capacity;
+} RAI_TensorBatchBlob;
+
+static void _RAI_TensorBatchDeleter(DLManagedTensor *arg) {
+    RAI_TensorBatchBlob *blob = arg->manager_ctx;
+    RedisModule_Free(blob->chunk);
+    RedisModule_Free(blob);
+    RedisModule_Free(arg->dl_tensor.shape);
+    RedisModule_Free(arg->dl_tensor.strides);
+    // The managed tensor is the first member of RAI_Tensor, so this frees the tensor itself.
+    RedisModule_Free(arg);
+}
+
+// Set the shape of a (non string) tensor whose first dimension is batch_size, and whose other
+// dimensions are the same as the given tensor dimensions.
+static void _RAI_TensorSetBatchShape(RAI_Tensor *t, int64_t batch_size, RAI_Tensor *sample) {
+    int n_dims = RAI_TensorNumDims(t);
+    int64_t *shape = t->tensor.dl_tensor.shape;
+    int64_t *strides = t->tensor.dl_tensor.strides;
+
+    size_t tensor_len = batch_size;
+    shape[0] = batch_size;
+    for (int i = 1; i < n_dims; i++) {
+        shape[i] = RAI_TensorDim(sample, i);
+        tensor_len *= shape[i];
+    }
+    strides[n_dims - 1] = 1;
+    for (int i = n_dims - 2; i >= 0; --i) {
+        strides[i] = strides[i + 1] * shape[i + 1];
+    }
+    t->len = tensor_len;
+}
+
+// Give a view tensor a copy of its data, so that it can be modified without affecting the
+// tensor which owns the shared blob.
+static void _RAI_TensorDetachView(RAI_Tensor *t) {
+    if (t->parent == NULL) {
+        return;
+    }
+    size_t blob_size = RAI_TensorByteSize(t);
+    char *data = RedisModule_Alloc(blob_size);
+    memcpy(data, RAI_TensorData(t), blob_size);
+    RAI_TensorFree(t->parent);
+    t->parent = NULL;
+    t->tensor.dl_tensor.data = data;
+    t->tensor.dl_tensor.byte_offset = 0;
+}
+
 static int _RAI_TensorParseStringValues(int argc, RedisModuleString **argv, RAI_Tensor *tensor,
                                         RAI_Error *err) {
     size_t total_len = 0;
@@ -222,6 +278,7 @@ RAI_Tensor *RAI_TensorNew(DLDataType data_type, const size_t *dims, int n_dims)
     RAI_Tensor *new_tensor = RedisModule_Alloc(sizeof(RAI_Tensor));
     new_tensor->refCount = 1;
     new_tensor->blobSize = 0;
+    new_tensor->parent = NULL;
 
     // Note that n_dim can be zero (i.e., tensor is a scalar)
     int64_t *shape = RedisModule_Calloc(n_dims, sizeof(*shape));
@@ -403,9 +460,67 @@ RAI_Tensor *RAI_TensorCreateByConcatenatingTensors(RAI_Tensor **tensors, long lo
     return ret;
 }
 
+RAI_Tensor *RAI_TensorConcatenateIntoBatch(RAI_Tensor **batch, RAI_Tensor **ts, long long n) {
+    RedisModule_Assert(n > 0);
+
+    // String tensors carry their elements offsets, so they are concatenated into a new tensor.
+    DLDataType data_type = RAI_TensorDataType(ts[0]);
+    if (data_type.code == kDLString) {
+        return RAI_TensorCreateByConcatenatingTensors(ts, n);
+    }
+
+    int n_dims = RAI_TensorNumDims(ts[0]);
+    int64_t batch_size = 0;
+    size_t blob_size = 0;
+    for (long long i = 0; i < n; i++) {
+        batch_size += RAI_TensorDim(ts[i], 0);
+        blob_size += RAI_TensorByteSize(ts[i]);
+    }
+
+    // The batch tensor from the previous run can be reused only if no one else holds a
+    // reference to it, and the current batch fits into its blob.
+    RAI_Tensor *ret = *batch;
+    if (ret && (__atomic_load_n(&ret->refCount, __ATOMIC_RELAXED) > 1 ||
+                RAI_TensorNumDims(ret) != n_dims ||
+                ((RAI_TensorBatchBlob *)ret->tensor.manager_ctx)->capacity < blob_size)) {
+        RAI_TensorFree(ret);
+        ret = NULL;
+    }
+    if (ret == NULL) {
+        size_t dims[n_dims];
+        for (int i = 0; i < n_dims; i++) {
+            dims[i] = RAI_TensorDim(ts[0], i);
+        }
+        ret = RAI_TensorNew(data_type, dims, n_dims);
+        RAI_TensorBatchBlob *blob = RedisModule_Alloc(sizeof(*blob));
+        blob->capacity = blob_size;
+        blob->chunk = RedisModule_Alloc(blob_size + BATCH_BLOB_ALIGNMENT - 1);
+        ret->tensor.manager_ctx = blob;
+        ret->tensor.deleter = _RAI_TensorBatchDeleter;
+        ret->tensor.dl_tensor.data =
+            (void *)(((uintptr_t)blob->chunk + BATCH_BLOB_ALIGNMENT - 1) &
+                     ~(uintptr_t)(BATCH_BLOB_ALIGNMENT - 1));
+        *batch = ret;
+    }
+
+    // The batch size (and the data type) may differ from the previous run.
+    ret->tensor.dl_tensor.dtype = data_type;
+    _RAI_TensorSetBatchShape(ret, batch_size, ts[0]);
+    ret->blobSize = blob_size;
+
+    // Write the input tensors data one after the other into the batch blob.
+    char *dst = RAI_TensorData(ret);
+    for (long long i = 0; i < n; i++) {
+        size_t tensor_blob_size = RAI_TensorByteSize(ts[i]);
+        memcpy(dst, RAI_TensorData(ts[i]), tensor_blob_size);
+        dst += tensor_blob_size;
+    }
+    return RAI_TensorGetShallowCopy(ret);
+}
+
 RAI_Tensor *RAI_TensorCreateBySlicingTensor(RAI_Tensor *t, long long offset, long long len) {
 
-    RedisModule_Assert(offset >= 0 || len >= 0 || offset + len <= RAI_TensorLength(t));
+    RedisModule_Assert(offset >= 0 && len >= 0 && offset + len <= RAI_TensorDim(t, 0));
     int n_dims = RAI_TensorNumDims(t);
     size_t dims[n_dims];
 
@@ -416,34 +531,39 @@ RAI_Tensor *RAI_TensorCreateBySlicingTensor(RAI_Tensor *t, long long offset, lon
     }
     dims[0] = len;
 
-    // Create a new tensor to store the sliced tensor in it.
+    // The view owns its meta-data only. It shares the blob of the tensor that owns it (a view of
+    // a view refers to the original owner), and describes the slice by its byte offset.
     DLDataType data_type = RAI_TensorDataType(t);
-    size_t data_type_size = RAI_TensorDataSize(t);
     RAI_Tensor *ret = RAI_TensorNew(data_type, dims, n_dims);
+    RAI_Tensor *owner = t->parent ? t->parent : t;
+    ret->parent = RAI_TensorGetShallowCopy(owner);
+    ret->tensor.dl_tensor.data = owner->tensor.dl_tensor.data;
+    ret->tensor.dl_tensor.device = t->tensor.dl_tensor.device;
 
-    // Copy the input tensor sliced data to the new tensor.
+    size_t slice_start, slice_end;
     if (data_type.code == kDLString) {
         size_t first_element_pos_in_slice = offset * basic_tensor_len;
         size_t first_element_pos_after_slice = (offset + len) * basic_tensor_len;
         uint64_t *strings_offsets = RAI_TensorStringElementsOffsets(t);
-        size_t blob_size =
-            first_element_pos_after_slice < RAI_TensorLength(t)
-                ? strings_offsets[first_element_pos_after_slice] -
-                      strings_offsets[first_element_pos_in_slice]
-                : RAI_TensorByteSize(t) - strings_offsets[first_element_pos_in_slice];
-        ret->blobSize = blob_size;
-        ret->tensor.dl_tensor.data = RedisModule_Alloc(blob_size);
-        memcpy(RAI_TensorData(ret), RAI_TensorData(t) + strings_offsets[offset * basic_tensor_len],
-               blob_size);
-        memcpy(RAI_TensorStringElementsOffsets(ret), strings_offsets + offset,
-               len * sizeof(uint64_t));
+        slice_start = first_element_pos_in_slice < RAI_TensorLength(t)
+                          ? strings_offsets[first_element_pos_in_slice]
+                          : RAI_TensorByteSize(t);
+        slice_end = first_element_pos_after_slice < RAI_TensorLength(t)
+                        ? strings_offsets[first_element_pos_after_slice]
+                        : RAI_TensorByteSize(t);
+
+        // Offsets are relative to the beginning of the view data.
+        uint64_t *ret_offsets = RAI_TensorStringElementsOffsets(ret);
+        for (size_t i = 0; i < RAI_TensorLength(ret); i++) {
+            ret_offsets[i] = strings_offsets[first_element_pos_in_slice + i] - slice_start;
+        }
     } else {
-        size_t blob_size = len * basic_tensor_len * data_type_size;
-        ret->tensor.dl_tensor.data = RedisModule_Alloc(blob_size);
-        memcpy(RAI_TensorData(ret), RAI_TensorData(t) + offset * basic_tensor_len * data_type_size,
-               blob_size);
-        ret->blobSize = blob_size;
+        size_t sample_size = basic_tensor_len * RAI_TensorDataSize(t);
+        slice_start = offset * sample_size;
+        slice_end = (offset + len) * sample_size;
     }
+    ret->tensor.dl_tensor.byte_offset = t->tensor.dl_tensor.byte_offset + slice_start;
+    ret->blobSize = slice_end - slice_start;
     return ret;
 }
 
@@ -576,7 +696,9 @@ size_t RAI_TensorByteSize(RAI_Tensor *t) {
     return t->blobSize;
 }
 
-char *RAI_TensorData(RAI_Tensor *t) { return t->tensor.dl_tensor.data; }
+char *RAI_TensorData(RAI_Tensor *t) {
+    return (char *)t->tensor.dl_tensor.data + t->tensor.dl_tensor.byte_offset;
+}
 
 uint64_t *RAI_TensorStringElementsOffsets(RAI_Tensor *tensor) {
     return tensor->tensor.dl_tensor.elements_length;
@@ -680,6 +802,7 @@ int RAI_TensorGetValueAsCString(RAI_Tensor *t, long long i, const char **val) {
 }
 
 int RAI_TensorSetData(RAI_Tensor *t, const char *data, size_t len) {
+    _RAI_TensorDetachView(t);
     DLDataType data_type = RAI_TensorDataType(t);
     if (data_type.code == kDLString) {
         if (_RAI_TensorParseStringsBlob(data, len, RAI_TensorLength(t),
@@ -687,7 +810,7 @@ int RAI_TensorSetData(RAI_Tensor *t, const char *data, size_t len) {
                                         NULL) != REDISMODULE_OK) {
             return 0;
         }
-        RedisModule_Free(RAI_TensorData(t));
+        RedisModule_Free(t->tensor.dl_tensor.data);
         t->tensor.dl_tensor.data = RedisModule_Alloc(len);
     } else if (data_type.code == kDLBool) {
         if (_RAI_TensorParseBooleansBlob(data, len, RAI_TensorLength(t), NULL) != REDISMODULE_OK) {
@@ -700,6 +823,7 @@ int RAI_TensorSetData(RAI_Tensor *t, const char *data, size_t len) {
 }
 
 int RAI_TensorSetValueFromLongLong(RAI_Tensor *t, long long i, long long val) {
+    _RAI_TensorDetachView(t);
     DLDataType dtype = RAI_TensorDataType(t);
     void *data = RAI_TensorData(t);
 
@@ -748,6 +872,7 @@ int RAI_TensorSetValueFromLongLong(RAI_Tensor *t, long long i, long long val) {
 }
 
 int RAI_TensorSetValueFromDouble(RAI_Tensor *t, long long i, double val) {
+    _RAI_TensorDetachView(t);
     DLDataType dtype = RAI_TensorDataType(t);
     void *data = RAI_TensorData(t);
 
@@ -793,7 +918,10 @@ void RAI_TensorFree(RAI_Tensor *t) {
         if (t->tensor.dl_tensor.strides) {
             RedisModule_Free(t->tensor.dl_tensor.strides);
         }
-        if (t->tensor.dl_tensor.data) {
+        if (t->parent) {
+            // The blob belongs to the parent tensor, release the view reference to it.
+            RAI_TensorFree(t->parent);
+        } else if (t->tensor.dl_tensor.data) {
             RedisModule_Free(t->tensor.dl_tensor.data);
         }
         if (t->tensor.dl_tensor.elements_length) {
@@ -844,6 +972,29 @@ int RAI_TensorGetFromKeyspace(RedisModuleCtx *ctx, RedisModuleString *keyName, R
     return REDISMODULE_OK;
 }
 
+int RAI_TensorSetInKeyspace(RedisModuleCtx *ctx, RedisModuleString *keyName, RAI_Tensor *t,
+                            RAI_Error *err) {
+    char data_type_str[8];
+    if (RAI_TensorGetDataTypeStr(RAI_TensorDataType(t), data_type_str) != REDISMODULE_OK) {
+        RAI_SetError(err, RAI_ETENSORSET, "ERR unsupported data type");
+        return REDISMODULE_ERR;
+    }
+    RedisModuleKey *key;
+    int status = RAI_TensorOpenKey(ctx, keyName, &key, REDISMODULE_READ | REDISMODULE_WRITE, err);
+    if (status == REDISMODULE_ERR) {
+        return REDISMODULE_ERR;
+    }
+    if (RedisModule_ModuleTypeSetValue(key, RedisAI_TensorType, t) != REDISMODULE_OK) {
+        RAI_SetError(err, RAI_ETENSORSET, "ERR could not save tensor");
+        RedisModule_CloseKey(key);
+        return REDISMODULE_ERR;
+    }
+    // Only if we got until here, tensor is saved in keyspace.
+    RAI_TensorReplicate(ctx, keyName, t);
+    RedisModule_CloseKey(key);
+    return REDISMODULE_OK;
+}
+
 void RAI_TensorReplicate(RedisModuleCtx *ctx, RedisModuleString *key, RAI_Tensor *t) {
     long long n_dims = RAI_TensorNumDims(t);
 
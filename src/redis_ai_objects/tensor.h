@@ -133,16 +133,35 @@ RAI_Tensor *RAI_TensorCreateFromDLTensor(DLManagedTensor *dl_tensor);
 RAI_Tensor *RAI_TensorCreateByConcatenatingTensors(RAI_Tensor **ts, long long n);
 
 /**
- * Allocate the memory and initialise an RAI_Tensor which is a slice of
- * the passed tensor having the given length, starting at the given offset.
+ * Allocate an RAI_Tensor which is a view of a slice of the passed tensor having the given
+ * length, starting at the given offset. The view shares the blob of the passed tensor (no
+ * data is copied): its data pointer is the one of the tensor owning the blob and the slice
+ * start is set in its byte_offset. The view holds a reference to the blob owner until the view
+ * is freed. Setting the data of a view gives it a copy of its own first.
  *
  * @param t input tensor
- * @param offset the index of the tensor's first dimension to start copy the data from
+ * @param offset the index of the tensor's first dimension where the slice starts
  * @param len the length of the sliced tensor (slice ends at offset+len index)
  * @return allocated RAI_Tensor on success, or NULL if the operation failed.
  */
 RAI_Tensor *RAI_TensorCreateBySlicingTensor(RAI_Tensor *t, long long offset, long long len);
 
+/**
+ * Concatenate the input tensors (along their first dimension) into a reusable batch
+ * tensor, whose blob is aligned to 64 bytes. If `*batch` holds a batch tensor from a
+ * previous call which is not referenced elsewhere and the input tensors fit into its blob,
+ * the batch tensor is reused. Otherwise, it is released and a new batch tensor is stored
+ * in `*batch`. String tensors are concatenated into a new tensor.
+ *
+ * @param batch place holder for the reusable batch tensor (owned by the caller, which should
+ * release it with RAI_TensorFree when it is no longer needed)
+ * @param ts input array of tensors to concatenate
+ * @param n number of input tensors
+ * @return a new reference to the concatenated tensor, to be released with RAI_TensorFree.
+ */
+RAI_Tensor *RAI_TensorConcatenateIntoBatch(RAI_Tensor **batch, RAI_Tensor **ts, long long n);
+
+
 /**
  * Helper method for creating the DLDataType represented by the input string
  *
@@ -209,7 +228,8 @@ long long RAI_TensorDim(RAI_Tensor *t, int dim);
 size_t RAI_TensorByteSize(RAI_Tensor *t);
 
 /**
- * Return the pointer to the tensor data blob (do not copy)
+ * Return the pointer to the tensor data blob (do not copy). For a view tensor, this is
+ * the start of its slice in the shared blob (i.e., the data pointer plus the byte offset).
  *
  * @param t input tensor
  * @return direct access to the array data pointer
@@ -365,6 +385,20 @@ int RAI_TensorOpenKey(RedisModuleCtx *ctx, RedisModuleString *keyName, RedisModu
 int RAI_TensorGetFromKeyspace(RedisModuleCtx *ctx, RedisModuleString *keyName, RedisModuleKey **key,
                               RAI_Tensor **tensor, int mode, RAI_Error *err);
 
+/**
+ * Helper method to store a tensor in the keyspace and replicate it. On success,
+ * the key takes ownership of the given tensor reference.
+ *
+ * @param ctx Context in which Redis modules operate
+ * @param keyName key name
+ * @param t tensor to store
+ * @param err used to store error status if one occurs.
+ * @return REDISMODULE_OK if the tensor was stored, or REDISMODULE_ERR if the key
+ * holds a value of another type, or the tensor data type is not supported.
+ */
+int RAI_TensorSetInKeyspace(RedisModuleCtx *ctx, RedisModuleString *keyName, RAI_Tensor *t,
+                            RAI_Error *err);
+
 /**
  * Helper method to replicate a tensor via an AI.TENSORSET command to the
  * replicas. This is used on MODELRUN, SCRIPTRUN, DAGRUN as a way to ensure that
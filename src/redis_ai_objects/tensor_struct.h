@@ -16,4 +16,6 @@ typedef struct RAI_Tensor {
     size_t len;
     long long refCount;
     size_t blobSize;
+    struct RAI_Tensor *parent; // The tensor which owns the blob that a view tensor points into
+                               // (NULL if the tensor owns its blob).
 } RAI_Tensor;
@@ -26,9 +26,14 @@
 #include "redis_ai_objects/stats.h"
 #include <pthread.h>
 #include <stdbool.h>
+#include <ctype.h>
 #include <string.h>
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <unistd.h>
 #include <execution/run_queue_info.h>
 
@@ -43,6 +48,7 @@
 #include "redis_ai_types/model_type.h"
 #include "redis_ai_types/script_type.h"
 #include "redis_ai_types/tensor_type.h"
+#include "serialization/RDB/decoder/model_loader.h"
 
 #define REDISAI_H_INCLUDE
 #include "redisai.h"
@@ -146,9 +152,262 @@ int RedisAI_ModelSet_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv,
     return ModelSetCommand(ctx, argv, argc);
 }
 
+/**
+ * Maps a model file from the configured model repository into memory (read only), so
+ * that backends read it from the page cache rather than from a copy. The path is
+ * relative to the repository, and it must resolve (following symbolic links) to a
+ * regular file under it. On success, the mapping should be released with munmap.
+ */
+static int _ModelStore_MapModelFile(const char *path, char **modeldef, size_t *modellen,
+                                    RAI_Error *err) {
+    const char *repository = Config_GetModelRepository();
+    if (!repository) {
+        RAI_SetError(err, RAI_EMODELCREATE, "ERR MODEL_REPOSITORY is not configured");
+        return REDISMODULE_ERR;
+    }
+
+    char fullpath[PATH_MAX];
+    char resolved[PATH_MAX];
+    size_t repository_len = strlen(repository);
+    if (snprintf(fullpath, PATH_MAX, "%s/%s", repository, path) >= PATH_MAX ||
+        realpath(fullpath, resolved) == NULL || strncmp(resolved, repository, repository_len) != 0 ||
+        resolved[repository_len] != '/') {
+        RAI_SetError(err, RAI_EMODELCREATE, "ERR Invalid model PATH");
+        return REDISMODULE_ERR;
+    }
+
+    int fd = open(resolved, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        RAI_SetError(err, RAI_EMODELCREATE, "ERR Could not read model file");
+        return REDISMODULE_ERR;
+    }
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        RAI_SetError(err, RAI_EMODELCREATE, "ERR Could not read model file");
+        return REDISMODULE_ERR;
+    }
+    // Backends read the model from beginning to end.
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+    *modeldef = data;
+    *modellen = st.st_size;
+    return REDISMODULE_OK;
+}
+
+// The state of an AI.MODELSTORE command. The model is created (usually in a background
+// thread), and then stored in the keyspace from the main thread.
+typedef struct ModelStoreCtx {
+    RedisModuleBlockedClient *client;
+    // The command arguments, retained until the model is stored (for replication).
+    RedisModuleString **argv;
+    RedisModuleString *keystr;
+    RAI_Backend backend;
+    const char *devicestr;
+    RedisModuleString *tag;
+    RAI_ModelOpts opts;
+    const char **inputs;
+    const char **outputs;
+    // The model definition is either mapped from a file (given with PATH), or given in one
+    // or more chunks.
+    bool from_path;
+    char *mapped_modeldef;
+    size_t mapped_modellen;
+    const char **chunks;
+    size_t *chunklens;
+    RAI_Model *model;
+    RAI_Error err;
+} ModelStoreCtx;
+
+static void _ModelStore_CreateModel(ModelStoreCtx *sctx) {
+    const char *modeldef;
+    size_t modellen;
+    char *buffer = NULL;
+
+    if (sctx->mapped_modeldef) {
+        modeldef = sctx->mapped_modeldef;
+        modellen = sctx->mapped_modellen;
+    } else if (array_len(sctx->chunks) == 1) {
+        modeldef = sctx->chunks[0];
+        modellen = sctx->chunklens[0];
+    } else {
+        modellen = 0;
+        for (size_t i = 0; i < array_len(sctx->chunks); i++) {
+            modellen += sctx->chunklens[i];
+        }
+        buffer = RedisModule_Calloc(modellen, sizeof(char));
+        size_t offset = 0;
+        for (size_t i = 0; i < array_len(sctx->chunks); i++) {
+            memcpy(buffer + offset, sctx->chunks[i], sctx->chunklens[i]);
+            offset += sctx->chunklens[i];
+        }
+        modeldef = buffer;
+    }
+
+    sctx->model = RAI_ModelCreate(sctx->backend, sctx->devicestr, sctx->tag, sctx->opts,
+                                  array_len(sctx->inputs), sctx->inputs,
+                                  array_len(sctx->outputs), sctx->outputs, modeldef, modellen,
+                                  &sctx->err);
+    if (buffer) {
+        RedisModule_Free(buffer);
+    }
+}
+
+// Replicates the command once the model is stored. A model that was loaded from a file is
+// replicated with its blob instead of its PATH (as the AOF rewrite does), since the replicas
+// and the AOF might not have the same file.
+static void _ModelStore_Replicate(RedisModuleCtx *ctx, ModelStoreCtx *sctx, RAI_Model *model) {
+    if (sctx->from_path) {
+        char *buffer = NULL;
+        size_t len = 0;
+        bool owned = false;
+        RAI_Error err = {0};
+        if (RAI_ModelGetBlob(model, &buffer, &len, &owned, &err) == REDISMODULE_OK) {
+            // AI.MODELSTORE <key> <backend> <device> ... BLOB <chunk> ... (instead of
+            // PATH <path>, which are the last two arguments)
+            const size_t nargs = array_len(sctx->argv) - 3;
+            const long long chunk_size = Config_GetModelChunkSize();
+            const size_t n_chunks = len > 0 ? (len + chunk_size - 1) / chunk_size : 1;
+            RedisModuleString **args = array_new(RedisModuleString *, nargs + 1 + n_chunks);
+            for (size_t i = 0; i < nargs; i++) {
+                args = array_append(args, sctx->argv[i + 1]);
+            }
+            args = array_append(args, RedisModule_CreateString(NULL, "BLOB", 4));
+            for (size_t i = 0; i < n_chunks; i++) {
+                size_t offset = i * chunk_size;
+                size_t chunk_len = len - offset < chunk_size ? len - offset : chunk_size;
+                args = array_append(args,
+                                    RedisModule_CreateString(NULL, buffer + offset, chunk_len));
+            }
+            RedisModule_Replicate(ctx, "AI.MODELSTORE", "v", args, array_len(args));
+            for (size_t i = nargs; i < array_len(args); i++) {
+                RedisModule_FreeString(NULL, args[i]);
+            }
+            array_free(args);
+            if (owned && buffer) {
+                RedisModule_Free(buffer);
+            }
+            return;
+        }
+        // Fall back to replicating the PATH, which is loaded if the replica has the file.
+        RedisModule_Log(ctx, "warning", "Could not replicate the model blob: %s", err.detail);
+        RAI_ClearError(&err);
+        if (owned && buffer) {
+            RedisModule_Free(buffer);
+        }
+    }
+    if (sctx->client) {
+        // The reply callback context does not refer to the original command.
+        RedisModule_Replicate(ctx, "AI.MODELSTORE", "v", sctx->argv + 1,
+                              (size_t)(array_len(sctx->argv) - 1));
+    } else {
+        RedisModule_ReplicateVerbatim(ctx);
+    }
+}
+
+// Stores the created model under the key and replies, or replies with the creation error.
+static int _ModelStore_StoreModel(RedisModuleCtx *ctx, ModelStoreCtx *sctx) {
+    RAI_Error err = {0};
+    if (sctx->err.code != RAI_OK) {
+        RedisModule_Log(ctx, "warning", "%s", sctx->err.detail);
+        return RedisModule_ReplyWithError(ctx, sctx->err.detail_oneline);
+    }
+
+    // TODO: if backend loaded, make sure there's a queue
+    if (!RunQueue_IsExists(sctx->devicestr)) {
+        RunQueueInfo *run_queue_info = RunQueue_Create(sctx->devicestr);
+        if (run_queue_info == NULL) {
+            return RedisModule_ReplyWithError(
+                ctx, "ERR Could not initialize queue on requested device");
+        }
+    }
+
+    RedisModuleKey *key =
+        RedisModule_OpenKey(ctx, sctx->keystr, REDISMODULE_READ | REDISMODULE_WRITE);
+    int type = RedisModule_KeyType(key);
+    if (type != REDISMODULE_KEYTYPE_EMPTY &&
+        !(type == REDISMODULE_KEYTYPE_MODULE &&
+          RedisModule_ModuleTypeGetType(key) == RAI_ModelRedisType())) {
+        RedisModule_CloseKey(key);
+        RAI_ModelFree(sctx->model, &err);
+        sctx->model = NULL;
+        if (err.code != RAI_OK) {
+            RedisModule_Log(ctx, "warning", "%s", err.detail);
+            int ret = RedisModule_ReplyWithError(ctx, err.detail_oneline);
+            RAI_ClearError(&err);
+            return ret;
+        }
+        return RedisModule_ReplyWithError(ctx, REDISMODULE_ERRORMSG_WRONGTYPE);
+    }
+
+    RAI_Model *model = sctx->model;
+    sctx->model = NULL;
+    RedisModule_ModuleTypeSetValue(key, RAI_ModelRedisType(), model);
+    RAI_RunStats *stats =
+        RAI_StatsCreate(sctx->keystr, RAI_MODEL, sctx->backend, sctx->devicestr, sctx->tag);
+    RAI_StatsStoreEntry(sctx->keystr, stats);
+    model->info = stats;
+
+    RedisModule_CloseKey(key);
+    RedisModule_ReplyWithSimpleString(ctx, "OK");
+    _ModelStore_Replicate(ctx, sctx, model);
+
+    return REDISMODULE_OK;
+}
+
+static void _ModelStore_FreeCtx(RedisModuleCtx *ctx, void *privdata) {
+    ModelStoreCtx *sctx = privdata;
+    if (sctx->model) {
+        RAI_Error err = {0};
+        RAI_ModelFree(sctx->model, &err);
+        RAI_ClearError(&err);
+    }
+    RAI_ClearError(&sctx->err);
+    if (sctx->mapped_modeldef) {
+        munmap(sctx->mapped_modeldef, sctx->mapped_modellen);
+    }
+    if (sctx->chunks) {
+        array_free(sctx->chunks);
+        array_free(sctx->chunklens);
+    }
+    if (sctx->inputs) {
+        array_free(sctx->inputs);
+        array_free(sctx->outputs);
+    }
+    if (sctx->tag) {
+        RedisModule_FreeString(NULL, sctx->tag);
+    }
+    if (sctx->argv) {
+        for (size_t i = 0; i < array_len(sctx->argv); i++) {
+            RedisModule_FreeString(NULL, sctx->argv[i]);
+        }
+        array_free(sctx->argv);
+    }
+    RedisModule_Free(sctx);
+}
+
+static int _ModelStore_Reply(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+    REDISMODULE_NOT_USED(argv);
+    REDISMODULE_NOT_USED(argc);
+    ModelStoreCtx *sctx = RedisModule_GetBlockedClientPrivateData(ctx);
+    return _ModelStore_StoreModel(ctx, sctx);
+}
+
+static void *_ModelStore_ThreadMain(void *arg) {
+    ModelStoreCtx *sctx = arg;
+    _ModelStore_CreateModel(sctx);
+    RedisModule_UnblockClient(sctx->client, sctx);
+    return NULL;
+}
+
 /**
  * AI.MODELSTORE model_key backend device [TAG tag] [BATCHSIZE n [MINBATCHSIZE m]]
- * [INPUTS input_count name1 name2 ... OUTPUTS output_count name1 name2 ...] BLOB model_blob
+ * [INPUTS input_count name1 name2 ... OUTPUTS output_count name1 name2 ...]
+ * BLOB model_blob | PATH model_path
  */
 int RedisAI_ModelStore_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     if (argc < 6)
@@ -231,10 +490,25 @@ int RedisAI_ModelStore_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **arg
                                               "ERR MINBATCHTIMEOUT specified without MINBATCHSIZE");
         }
     }
+
+    unsigned long long latencytarget = 0;
+    if (AC_AdvanceIfMatch(&ac, "LATENCYTARGET")) {
+        if (AC_GetUnsignedLongLong(&ac, &latencytarget, 0) != AC_OK || latencytarget == 0) {
+            return RedisModule_ReplyWithError(ctx, "ERR Invalid argument for LATENCYTARGET");
+        }
+        if (batchsize == 0) {
+            return RedisModule_ReplyWithError(ctx, "ERR LATENCYTARGET specified without BATCHSIZE");
+        }
+        if (minbatchsize > 0) {
+            return RedisModule_ReplyWithError(
+                ctx, "ERR LATENCYTARGET cannot be specified together with MINBATCHSIZE");
+        }
+    }
     RAI_ModelOpts opts = {
         .batchsize = batchsize,
         .minbatchsize = minbatchsize,
         .minbatchtimeout = minbatchtimeout,
+        .latencytarget = latencytarget,
         .backends_intra_op_parallelism = Config_GetBackendsIntraOpParallelism(),
         .backends_inter_op_parallelism = Config_GetBackendsInterOpParallelism(),
     };
@@ -289,10 +563,17 @@ int RedisAI_ModelStore_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **arg
         AC_GetString(&ac, &arg_string, NULL, 0);
     }
 
-    if (strcasecmp(arg_string, "BLOB") != 0) {
+    // The model is given either as a blob (possibly in chunks), or as the path of a model
+    // file in the model repository.
+    bool from_path = strcasecmp(arg_string, "PATH") == 0;
+    if (!from_path && strcasecmp(arg_string, "BLOB") != 0) {
         return RedisModule_ReplyWithError(ctx, "ERR Invalid argument, expected BLOB");
     }
 
+    if (from_path && AC_NumRemaining(&ac) != 1) {
+        return RedisModule_ReplyWithError(ctx, "ERR PATH requires a single model file path");
+    }
+
     if (AC_IsAtEnd(&ac)) {
         return RedisModule_ReplyWithError(ctx, "ERR Insufficient arguments, missing model BLOB");
     }
@@ -300,92 +581,83 @@ int RedisAI_ModelStore_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **arg
     ArgsCursor blobsac;
     AC_GetSliceToEnd(&ac, &blobsac);
 
-    size_t modellen;
-    char *modeldef;
-
-    if (blobsac.argc == 1) {
-        AC_GetString(&blobsac, (const char **)&modeldef, &modellen, 0);
+    ModelStoreCtx *sctx = RedisModule_Calloc(1, sizeof(*sctx));
+    sctx->from_path = from_path;
+    if (from_path) {
+        const char *path;
+        AC_GetString(&blobsac, &path, NULL, 0);
+        if (_ModelStore_MapModelFile(path, &sctx->mapped_modeldef, &sctx->mapped_modellen,
+                                     &sctx->err) != REDISMODULE_OK) {
+            int ret = RedisModule_ReplyWithError(ctx, sctx->err.detail_oneline);
+            _ModelStore_FreeCtx(ctx, sctx);
+            return ret;
+        }
     } else {
-        const char *chunks[blobsac.argc];
-        size_t chunklens[blobsac.argc];
-        modellen = 0;
+        sctx->chunks = array_new(const char *, blobsac.argc);
+        sctx->chunklens = array_new(size_t, blobsac.argc);
         while (!AC_IsAtEnd(&blobsac)) {
-            AC_GetString(&blobsac, &chunks[blobsac.offset], &chunklens[blobsac.offset], 0);
-            modellen += chunklens[blobsac.offset - 1];
-        }
-
-        modeldef = RedisModule_Calloc(modellen, sizeof(char));
-        size_t offset = 0;
-        for (size_t i = 0; i < blobsac.argc; i++) {
-            memcpy(modeldef + offset, chunks[i], chunklens[i]);
-            offset += chunklens[i];
+            const char *chunk;
+            size_t chunklen;
+            AC_GetString(&blobsac, &chunk, &chunklen, 0);
+            sctx->chunks = array_append(sctx->chunks, chunk);
+            sctx->chunklens = array_append(sctx->chunklens, chunklen);
         }
     }
 
-    RAI_Error err = {0};
-    RAI_Model *model = NULL;
-    model = RAI_ModelCreate(backend, devicestr, tag, opts, ninputs, inputs, noutputs, outputs,
-                            modeldef, modellen, &err);
-
-    if (err.code == RAI_EBACKENDNOTLOADED) {
+    if (!RAI_IsBackendLoaded(backend)) {
         RedisModule_Log(ctx, "warning", "backend %s not loaded, will try loading default backend",
                         bckstr);
-        int ret = RAI_LoadDefaultBackend(ctx, backend);
-        if (ret == REDISMODULE_ERR) {
+        if (RAI_LoadDefaultBackend(ctx, backend) == REDISMODULE_ERR) {
             RedisModule_Log(ctx, "warning", "could not load %s default backend", bckstr);
-            int ret = RedisModule_ReplyWithError(ctx, "ERR Could not load backend");
-            RAI_ClearError(&err);
-            return ret;
+            _ModelStore_FreeCtx(ctx, sctx);
+            return RedisModule_ReplyWithError(ctx, "ERR Could not load backend");
         }
-        RAI_ClearError(&err);
-        model = RAI_ModelCreate(backend, devicestr, tag, opts, ninputs, inputs, noutputs, outputs,
-                                modeldef, modellen, &err);
     }
 
-    if (blobsac.argc > 1) {
-        RedisModule_Free(modeldef);
+    sctx->keystr = keystr;
+    sctx->backend = backend;
+    sctx->devicestr = devicestr;
+    // The background thread works on its own copy of the tag.
+    sctx->tag = tag ? RedisModule_CreateStringFromString(NULL, tag) : NULL;
+    sctx->opts = opts;
+    sctx->inputs = array_new(const char *, ninputs);
+    for (size_t i = 0; i < ninputs; i++) {
+        sctx->inputs = array_append(sctx->inputs, inputs[i]);
     }
-
-    if (err.code != RAI_OK) {
-        RedisModule_Log(ctx, "warning", "%s", err.detail);
-        int ret = RedisModule_ReplyWithError(ctx, err.detail_oneline);
-        RAI_ClearError(&err);
-        return ret;
+    sctx->outputs = array_new(const char *, noutputs);
+    for (size_t i = 0; i < noutputs; i++) {
+        sctx->outputs = array_append(sctx->outputs, outputs[i]);
     }
 
-    // TODO: if backend loaded, make sure there's a queue
-    if (!RunQueue_IsExists(devicestr)) {
-        RunQueueInfo *run_queue_info = RunQueue_Create(devicestr);
-        if (run_queue_info == NULL) {
-            RAI_ModelFree(model, &err);
-            RedisModule_ReplyWithError(ctx, "ERR Could not initialize queue on requested device");
-        }
+    // The arguments (which the model definition and the names point to) are retained until
+    // the command is replicated, once the model is stored.
+    sctx->argv = array_new(RedisModuleString *, argc);
+    for (int i = 0; i < argc; i++) {
+        sctx->argv = array_append(sctx->argv, RAI_HoldString(argv[i]));
     }
 
-    RedisModuleKey *key = RedisModule_OpenKey(ctx, keystr, REDISMODULE_READ | REDISMODULE_WRITE);
-    int type = RedisModule_KeyType(key);
-    if (type != REDISMODULE_KEYTYPE_EMPTY &&
-        !(type == REDISMODULE_KEYTYPE_MODULE &&
-          RedisModule_ModuleTypeGetType(key) == RAI_ModelRedisType())) {
-        RedisModule_CloseKey(key);
-        RAI_ModelFree(model, &err);
-        if (err.code != RAI_OK) {
-            RedisModule_Log(ctx, "warning", "%s", err.detail);
-            int ret = RedisModule_ReplyWithError(ctx, err.detail_oneline);
-            RAI_ClearError(&err);
-            return ret;
-        }
-        return RedisModule_ReplyWithError(ctx, REDISMODULE_ERRORMSG_WRONGTYPE);
+    // Creating the model (e.g., a backend session for a large model) may take a long time,
+    // so it is done in a background thread while the client is blocked. Where clients cannot
+    // be blocked (e.g., in a transaction or when loading the AOF), it is done synchronously.
+    int flags = RedisModule_GetContextFlags(ctx);
+    if (flags & (REDISMODULE_CTX_FLAGS_MULTI | REDISMODULE_CTX_FLAGS_LUA |
+                 REDISMODULE_CTX_FLAGS_LOADING | REDISMODULE_CTX_FLAGS_REPLICATED |
+                 REDISMODULE_CTX_FLAGS_DENY_BLOCKING)) {
+        _ModelStore_CreateModel(sctx);
+        int ret = _ModelStore_StoreModel(ctx, sctx);
+        _ModelStore_FreeCtx(ctx, sctx);
+        return ret;
     }
 
-    RedisModule_ModuleTypeSetValue(key, RAI_ModelRedisType(), model);
-    RAI_RunStats *stats = RAI_StatsCreate(keystr, RAI_MODEL, backend, devicestr, tag);
-    RAI_StatsStoreEntry(keystr, stats);
-    model->info = stats;
-
-    RedisModule_CloseKey(key);
-    RedisModule_ReplyWithSimpleString(ctx, "OK");
-    RedisModule_ReplicateVerbatim(ctx);
+    sctx->client = RedisModule_BlockClient(ctx, _ModelStore_Reply, NULL, _ModelStore_FreeCtx, 0);
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attr, _ModelStore_ThreadMain, sctx) != 0) {
+        _ModelStore_ThreadMain(sctx);
+    }
+    pthread_attr_destroy(&attr);
 
     return REDISMODULE_OK;
 }
@@ -433,13 +705,14 @@ int RedisAI_ModelGet_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv,
 
     char *buffer = NULL;
     size_t len = 0;
+    bool owned = false;
 
     if (!meta || blob) {
-        RAI_ModelSerialize(mto, &buffer, &len, &err);
+        RAI_ModelGetBlob(mto, &buffer, &len, &owned, &err);
         if (RAI_GetErrorCode(&err) != RAI_OK) {
             int ret = RedisModule_ReplyWithError(ctx, RAI_GetErrorOneLine(&err));
             RAI_ClearError(&err);
-            if (*buffer) {
+            if (owned && buffer) {
                 RedisModule_Free(buffer);
             }
             return ret;
@@ -448,13 +721,19 @@ int RedisAI_ModelGet_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv,
 
     if (!meta && blob) {
         RAI_ReplyWithChunks(ctx, buffer, len);
-        RedisModule_Free(buffer);
+        if (owned) {
+            RedisModule_Free(buffer);
+        }
         return REDISMODULE_OK;
     }
 
     // The only case where we return only META, is when META is given but BLOB
     // was not. Otherwise, we return both META+SOURCE
-    const int out_entries = (meta && !blob) ? 16 : 18;
+    // The latencytarget field is reported only for models that use adaptive batching.
+    int out_entries = (meta && !blob) ? 16 : 18;
+    if (mto->opts.latencytarget > 0) {
+        out_entries += 2;
+    }
     RedisModule_ReplyWithArray(ctx, out_entries);
 
     RedisModule_ReplyWithCString(ctx, "backend");
@@ -494,11 +773,18 @@ int RedisAI_ModelGet_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv,
     RedisModule_ReplyWithCString(ctx, "minbatchtimeout");
     RedisModule_ReplyWithLongLong(ctx, (long)mto->opts.minbatchtimeout);
 
+    if (mto->opts.latencytarget > 0) {
+        RedisModule_ReplyWithCString(ctx, "latencytarget");
+        RedisModule_ReplyWithLongLong(ctx, (long)mto->opts.latencytarget);
+    }
+
     // This condition is the negation of (meta && !blob)
     if (!meta || blob) {
         RedisModule_ReplyWithCString(ctx, "blob");
         RAI_ReplyWithChunks(ctx, buffer, len);
-        RedisModule_Free(buffer);
+        if (owned) {
+            RedisModule_Free(buffer);
+        }
     }
 
     return REDISMODULE_OK;
@@ -662,6 +948,9 @@ int RedisAI_ScriptGet_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv
     // We return (META+SOURCE) if both args are given, or if none of them was given.
     // The only case where we return only META data, is if META is given while SOURCE was not.
     int out_entries = (source || !meta) ? 8 : 6;
+    if (sto->batchOpts) {
+        out_entries += 2;
+    }
     RedisModule_ReplyWithArray(ctx, out_entries);
 
     RedisModule_ReplyWithCString(ctx, "device");
@@ -674,6 +963,25 @@ int RedisAI_ScriptGet_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv
     for (size_t i = 0; i < nEntryPoints; i++) {
         RedisModule_ReplyWithCString(ctx, sto->entryPoints[i]);
     }
+    if (sto->batchOpts) {
+        // For every batched entry point: its name, batchsize, minbatchsize and minbatchtimeout.
+        RedisModule_ReplyWithCString(ctx, "batching");
+        RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+        long n_batched = 0;
+        for (size_t i = 0; i < nEntryPoints; i++) {
+            RAI_ScriptBatchOpts *opts = &sto->batchOpts[i];
+            if (opts->batchsize == 0) {
+                continue;
+            }
+            RedisModule_ReplyWithArray(ctx, 4);
+            RedisModule_ReplyWithCString(ctx, sto->entryPoints[i]);
+            RedisModule_ReplyWithLongLong(ctx, (long long)opts->batchsize);
+            RedisModule_ReplyWithLongLong(ctx, (long long)opts->minbatchsize);
+            RedisModule_ReplyWithLongLong(ctx, (long long)opts->minbatchtimeout);
+            n_batched++;
+        }
+        RedisModule_ReplySetArrayLength(ctx, n_batched);
+    }
     if (source || !meta) {
         RedisModule_ReplyWithCString(ctx, "source");
         RedisModule_ReplyWithCString(ctx, sto->scriptdef);
@@ -711,8 +1019,67 @@ int RedisAI_ScriptSet_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv
     return ScriptSetCommand(ctx, argv, argc);
 }
 
+/**
+ * Parses the optional batching clauses of AI.SCRIPTSTORE, one per batched entry point:
+ * [BATCHSIZE entry_point n [MINBATCHSIZE m [MINBATCHTIMEOUT t]]]...
+ * On failure, an error is replied and REDISMODULE_ERR is returned.
+ */
+static int _ScriptStore_ParseBatching(RedisModuleCtx *ctx, ArgsCursor *ac, const char **entryPoints,
+                                      RAI_ScriptBatchOpts **batchOpts) {
+    size_t nEntryPoints = array_len(entryPoints);
+    while (AC_AdvanceIfMatch(ac, "BATCHSIZE")) {
+        const char *entryPoint;
+        unsigned long long batchsize;
+        if (AC_GetString(ac, &entryPoint, NULL, 0) != AC_OK ||
+            AC_GetUnsignedLongLong(ac, &batchsize, 0) != AC_OK) {
+            RedisModule_ReplyWithError(ctx, "ERR Invalid argument for BATCHSIZE");
+            return REDISMODULE_ERR;
+        }
+        size_t i = 0;
+        while (i < nEntryPoints && strcmp(entryPoint, entryPoints[i]) != 0) {
+            i++;
+        }
+        if (i == nEntryPoints) {
+            RedisModule_ReplyWithError(ctx, "ERR BATCHSIZE specified for an unknown entry point");
+            return REDISMODULE_ERR;
+        }
+        if (!*batchOpts) {
+            *batchOpts = RedisModule_Calloc(nEntryPoints, sizeof(**batchOpts));
+        }
+        RAI_ScriptBatchOpts *opts = &(*batchOpts)[i];
+        opts->batchsize = batchsize;
+
+        if (AC_AdvanceIfMatch(ac, "MINBATCHSIZE")) {
+            unsigned long long minbatchsize;
+            if (AC_GetUnsignedLongLong(ac, &minbatchsize, 0) != AC_OK) {
+                RedisModule_ReplyWithError(ctx, "ERR Invalid argument for MINBATCHSIZE");
+                return REDISMODULE_ERR;
+            }
+            if (batchsize == 0 && minbatchsize > 0) {
+                RedisModule_ReplyWithError(ctx, "ERR MINBATCHSIZE specified without BATCHSIZE");
+                return REDISMODULE_ERR;
+            }
+            opts->minbatchsize = minbatchsize;
+        }
+        if (AC_AdvanceIfMatch(ac, "MINBATCHTIMEOUT")) {
+            unsigned long long minbatchtimeout;
+            if (AC_GetUnsignedLongLong(ac, &minbatchtimeout, 0) != AC_OK) {
+                RedisModule_ReplyWithError(ctx, "ERR Invalid argument for MINBATCHTIMEOUT");
+                return REDISMODULE_ERR;
+            }
+            if (opts->minbatchsize == 0 && minbatchtimeout > 0) {
+                RedisModule_ReplyWithError(ctx,
+                                           "ERR MINBATCHTIMEOUT specified without MINBATCHSIZE");
+                return REDISMODULE_ERR;
+            }
+            opts->minbatchtimeout = minbatchtimeout;
+        }
+    }
+    return REDISMODULE_OK;
+}
+
 int RedisAI_ScriptStore_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
-    // AI.SCRIPTSTORE <key> <device> ENTRY_POINTS 1 ep1 SOURCE blob
+    // AI.SCRIPTSTORE <key> <device> ENTRY_POINTS 1 ep1 [BATCHSIZE ep1 n] SOURCE blob
     if (argc < 8)
         return RedisModule_WrongArity(ctx);
 
@@ -752,6 +1119,13 @@ int RedisAI_ScriptStore_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **ar
         entryPoints = array_append(entryPoints, entryPoint);
     }
 
+    RAI_ScriptBatchOpts *batchOpts = NULL;
+    if (_ScriptStore_ParseBatching(ctx, &ac, entryPoints, &batchOpts) != REDISMODULE_OK) {
+        array_free(entryPoints);
+        RedisModule_Free(batchOpts);
+        return REDISMODULE_ERR;
+    }
+
     size_t scriptlen;
     const char *scriptdef = NULL;
 
@@ -761,13 +1135,15 @@ int RedisAI_ScriptStore_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **ar
 
     if (scriptdef == NULL) {
         array_free(entryPoints);
+        RedisModule_Free(batchOpts);
         return RedisModule_ReplyWithError(ctx, "ERR Insufficient arguments, missing script SOURCE");
     }
 
     RAI_Script *script = NULL;
 
     RAI_Error err = {0};
-    script = RAI_ScriptCompile(devicestr, tag, scriptdef, entryPoints, (size_t)nEntryPoints, &err);
+    script = RAI_ScriptCompile(devicestr, tag, scriptdef, entryPoints, (size_t)nEntryPoints,
+                               batchOpts, &err);
 
     if (err.code == RAI_EBACKENDNOTLOADED) {
         RedisModule_Log(ctx, "warning",
@@ -775,16 +1151,18 @@ int RedisAI_ScriptStore_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **ar
         int ret = RAI_LoadDefaultBackend(ctx, RAI_BACKEND_TORCH);
         if (ret == REDISMODULE_ERR) {
             array_free(entryPoints);
+            RedisModule_Free(batchOpts);
             RedisModule_Log(ctx, "warning", "Could not load TORCH default backend");
             int ret = RedisModule_ReplyWithError(ctx, "ERR Could not load backend");
             RAI_ClearError(&err);
             return ret;
         }
         RAI_ClearError(&err);
-        script =
-            RAI_ScriptCompile(devicestr, tag, scriptdef, entryPoints, (size_t)nEntryPoints, &err);
+        script = RAI_ScriptCompile(devicestr, tag, scriptdef, entryPoints, (size_t)nEntryPoints,
+                                   batchOpts, &err);
     }
     array_free(entryPoints);
+    RedisModule_Free(batchOpts);
     if (err.code != RAI_OK) {
         int ret = RedisModule_ReplyWithError(ctx, err.detail_oneline);
         RAI_ClearError(&err);
@@ -852,6 +1230,19 @@ int RedisAI_ScriptScan_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **arg
     return REDISMODULE_OK;
 }
 
+static void _RedisAI_ReplyWithLatencies(RedisModuleCtx *ctx, const char *name,
+                                        RAI_Histogram *histogram) {
+    unsigned long long values[RAI_STATS_NUM_PERCENTILES];
+    RAI_HistogramPercentiles(histogram, RAI_StatsPercentiles, RAI_STATS_NUM_PERCENTILES, values);
+    for (size_t i = 0; i < RAI_STATS_NUM_PERCENTILES; i++) {
+        RedisModuleString *field =
+            RedisModule_CreateStringPrintf(NULL, "%s_%s", name, RAI_StatsPercentileNames[i]);
+        RedisModule_ReplyWithString(ctx, field);
+        RedisModule_ReplyWithLongLong(ctx, (long long)values[i]);
+        RedisModule_FreeString(NULL, field);
+    }
+}
+
 /**
  * AI.INFO <model_or_script_key> [RESETSTAT]
  */
@@ -874,7 +1265,7 @@ int RedisAI_Info_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
         }
     }
 
-    RedisModule_ReplyWithArray(ctx, 18);
+    RedisModule_ReplyWithArray(ctx, 18 + 6 * RAI_STATS_NUM_PERCENTILES);
 
     RedisModule_ReplyWithCString(ctx, "key");
     RedisModule_ReplyWithString(ctx, rstats->key);
@@ -906,6 +1297,9 @@ int RedisAI_Info_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     RedisModule_ReplyWithLongLong(ctx, (long long)rstats->calls);
     RedisModule_ReplyWithCString(ctx, "errors");
     RedisModule_ReplyWithLongLong(ctx, (long long)rstats->n_errors);
+    _RedisAI_ReplyWithLatencies(ctx, "duration", &rstats->exec_latency);
+    _RedisAI_ReplyWithLatencies(ctx, "queue_wait", &rstats->queue_latency);
+    _RedisAI_ReplyWithLatencies(ctx, "end_to_end", &rstats->total_latency);
 
     return REDISMODULE_OK;
 }
@@ -951,6 +1345,8 @@ int RedisAI_Config_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, i
                 return RedisModule_ReplyWithCString(ctx, Config_GetBackendsPath());
             } else if (!strcasecmp(config, "MODEL_CHUNK_SIZE")) {
                 return RedisModule_ReplyWithLongLong(ctx, Config_GetModelChunkSize());
+            } else if (!strcasecmp(config, "MODEL_REPOSITORY") && Config_GetModelRepository()) {
+                return RedisModule_ReplyWithCString(ctx, Config_GetModelRepository());
             } else {
                 return RedisModule_ReplyWithNull(ctx);
             }
@@ -1141,6 +1537,7 @@ static int RedisAI_RegisterApi(RedisModuleCtx *ctx) {
 
 static void _moduleInfo_getBackendsInfo(RedisModuleInfoCtx *ctx) {
     RedisModule_InfoAddSection(ctx, "backends_info");
+    RedisModule_InfoAddFieldULongLong(ctx, "models_load_failed", RAI_ModelGetLoadFailedCount());
     if (RAI_backends.tf.get_version) {
         RedisModule_InfoAddFieldCString(ctx, "TensorFlow_version",
                                         (char *)RAI_backends.tf.get_version());
@@ -1148,10 +1545,18 @@ static void _moduleInfo_getBackendsInfo(RedisModuleInfoCtx *ctx) {
     if (RAI_backends.tflite.get_version) {
         RedisModule_InfoAddFieldCString(ctx, "TensorFlowLite_version",
                                         (char *)RAI_backends.tflite.get_version());
+        RedisModule_InfoAddFieldULongLong(ctx, "TensorFlowLite_shape_cache_hits",
+                                          RAI_backends.tflite.get_shape_cache_hits());
+        RedisModule_InfoAddFieldULongLong(ctx, "TensorFlowLite_shape_cache_misses",
+                                          RAI_backends.tflite.get_shape_cache_misses());
     }
     if (RAI_backends.torch.get_version) {
         RedisModule_InfoAddFieldCString(ctx, "Torch_version",
                                         (char *)RAI_backends.torch.get_version());
+        RedisModule_InfoAddFieldULongLong(ctx, "Torch_outputs_copied",
+                                          RAI_backends.torch.get_outputs_copied());
+        RedisModule_InfoAddFieldULongLong(ctx, "Torch_outputs_copies_saved",
+                                          RAI_backends.torch.get_outputs_copies_saved());
     }
     if (RAI_backends.onnx.get_version) {
         RedisModule_InfoAddFieldCString(ctx, "onnxruntime_version",
@@ -1165,6 +1570,91 @@ static void _moduleInfo_getBackendsInfo(RedisModuleInfoCtx *ctx) {
     }
 }
 
+static void _moduleInfo_addQueueField(RedisModuleInfoCtx *ctx, const char *queue_name,
+                                      const char *name, double value) {
+    RedisModuleString *field = RedisModule_CreateStringPrintf(NULL, "queue_%s_%s", queue_name, name);
+    RedisModule_InfoAddFieldDouble(ctx, (char *)RedisModule_StringPtrLen(field, NULL), value);
+    RedisModule_FreeString(NULL, field);
+}
+
+/**
+ * Adds a "queues" section with the load metrics of every device's run queue. The
+ * enqueued, dequeued and busy_us counters are cumulative, so rates are computed by
+ * the client from two INFO calls, and INFO does not reset anything.
+ */
+static void _moduleInfo_getQueuesInfo(RedisModuleInfoCtx *ctx) {
+    RedisModule_InfoAddSection(ctx, "queues");
+    AI_dictIterator *iter = AI_dictGetSafeIterator(RunQueues);
+    AI_dictEntry *entry;
+    while ((entry = AI_dictNext(iter))) {
+        char *queue_name = (char *)AI_dictGetKey(entry);
+        RunQueueInfo *run_queue_info = (RunQueueInfo *)AI_dictGetVal(entry);
+        if (!run_queue_info) {
+            continue;
+        }
+        RunQueueStatsReport report;
+        RunQueue_GetStatsReport(run_queue_info, &report);
+        _moduleInfo_addQueueField(ctx, queue_name, "depth", (double)report.depth);
+        _moduleInfo_addQueueField(ctx, queue_name, "enqueued", (double)report.enqueued);
+        _moduleInfo_addQueueField(ctx, queue_name, "dequeued", (double)report.dequeued);
+        _moduleInfo_addQueueField(ctx, queue_name, "avg_wait_us", report.avg_wait_us);
+        _moduleInfo_addQueueField(ctx, queue_name, "max_wait_us", (double)report.max_wait_us);
+        _moduleInfo_addQueueField(ctx, queue_name, "busy_us", (double)report.busy_us);
+        _moduleInfo_addQueueField(ctx, queue_name, "batches", (double)report.batches);
+        _moduleInfo_addQueueField(ctx, queue_name, "avg_batch_fill", report.avg_batch_fill);
+    }
+    AI_dictReleaseIterator(iter);
+}
+
+static void _moduleInfo_addLatencies(RedisModuleInfoCtx *ctx, const char *name,
+                                     RAI_Histogram *histogram) {
+    unsigned long long values[RAI_STATS_NUM_PERCENTILES];
+    RAI_HistogramPercentiles(histogram, RAI_StatsPercentiles, RAI_STATS_NUM_PERCENTILES, values);
+    for (size_t i = 0; i < RAI_STATS_NUM_PERCENTILES; i++) {
+        RedisModuleString *field =
+            RedisModule_CreateStringPrintf(NULL, "%s_%s", name, RAI_StatsPercentileNames[i]);
+        RedisModule_InfoAddFieldULongLong(ctx, (char *)RedisModule_StringPtrLen(field, NULL),
+                                          values[i]);
+        RedisModule_FreeString(NULL, field);
+    }
+}
+
+/**
+ * Adds a "latency" section with a dict field per model/script key, that holds the
+ * percentiles of its latency histograms (in microseconds). Characters that would
+ * break the INFO format are replaced in the key names.
+ */
+static void _moduleInfo_getLatencyInfo(RedisModuleInfoCtx *ctx) {
+    RedisModule_InfoAddSection(ctx, "latency");
+    RAI_RunType types[] = {RAI_MODEL, RAI_SCRIPT};
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        long long nkeys;
+        RedisModuleString **keys;
+        RedisModuleString **tags;
+        RAI_StatsGetAllEntries(types[t], &nkeys, &keys, &tags);
+        for (long long i = 0; i < nkeys; i++) {
+            RAI_RunStats *rstats = RAI_StatsGetEntry(keys[i]);
+            size_t len;
+            const char *key = RedisModule_StringPtrLen(keys[i], &len);
+            char *field = RedisModule_Alloc(len + 1);
+            for (size_t j = 0; j < len; j++) {
+                char c = key[j];
+                field[j] = (c == ':' || c == ',' || c == '=' || c == '#' || isspace(c)) ? '_' : c;
+            }
+            field[len] = '\0';
+            RedisModule_InfoBeginDictField(ctx, field);
+            RedisModule_InfoAddFieldULongLong(ctx, "calls", rstats->calls);
+            _moduleInfo_addLatencies(ctx, "duration", &rstats->exec_latency);
+            _moduleInfo_addLatencies(ctx, "queue_wait", &rstats->queue_latency);
+            _moduleInfo_addLatencies(ctx, "end_to_end", &rstats->total_latency);
+            RedisModule_InfoEndDictField(ctx);
+            RedisModule_Free(field);
+        }
+        RedisModule_Free(keys);
+        RedisModule_Free(tags);
+    }
+}
+
 void RAI_moduleInfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report) {
     RedisModule_InfoAddSection(ctx, "versions");
     RedisModuleString *rai_version = RedisModule_CreateStringPrintf(
@@ -1192,6 +1682,12 @@ void RAI_moduleInfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report) {
     RedisModule_InfoAddFieldLongLong(ctx, "model_execution_timeout",
                                      Config_GetModelExecutionTimeout());
     RedisModule_InfoAddFieldLongLong(ctx, "backend_memory_limit", Config_GetBackendMemoryLimit());
+    RedisModule_InfoAddFieldLongLong(ctx, "model_session_pool_size",
+                                     Config_GetModelSessionPoolSize());
+    if (Config_GetModelRepository()) {
+        RedisModule_InfoAddFieldCString(ctx, "model_repository",
+                                        (char *)Config_GetModelRepository());
+    }
     _moduleInfo_getBackendsInfo(ctx);
 
     struct rusage self_ru, c_ru;
@@ -1282,11 +1778,17 @@ void RAI_moduleInfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report) {
         entry = AI_dictNext(iter);
     }
     AI_dictReleaseIterator(iter);
+
+    _moduleInfo_getQueuesInfo(ctx);
+    _moduleInfo_getLatencyInfo(ctx);
 }
 
 void RAI_CleanupModule(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t subevent, void *data) {
     RedisModule_Log(ctx, "notice", "%s", "Clearing resources on shutdown");
     RedisModule_Free(Config_GetBackendsPath());
+    if (Config_GetModelRepository()) {
+        RedisModule_Free((char *)Config_GetModelRepository());
+    }
 }
 
 int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
@@ -1435,6 +1937,7 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
     RedisModule_SetModuleOptions(ctx, REDISMODULE_OPTIONS_HANDLE_IO_ERRORS);
 
     RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_Shutdown, RAI_CleanupModule);
+    RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_Loading, ModelLoader_OnLoadingEvent);
 
     if (Config_SetLoadTimeParams(ctx, argv, argc) != REDISMODULE_OK) {
         return REDISMODULE_ERR;
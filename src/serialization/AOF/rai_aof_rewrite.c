@@ -33,22 +33,23 @@ void RAI_AOFRewriteModel(RedisModuleIO *aof, RedisModuleString *key, void *value
 
     char *buffer = NULL;
     size_t len = 0;
+    bool owned;
     RAI_Error err = {0};
 
-    int ret = RAI_ModelSerialize(model, &buffer, &len, &err);
+    int ret = RAI_ModelGetBlob(model, &buffer, &len, &owned, &err);
 
     if (err.code != RAI_OK) {
 
         printf("ERR: %s\n", err.detail);
         RAI_ClearError(&err);
-        if (buffer) {
+        if (owned && buffer) {
             RedisModule_Free(buffer);
         }
         return;
     }
 
     // AI.MODELSTORE model_key backend device [TAG tag]
-    // [BATCHSIZE n [MINBATCHSIZE m [MINBATCHTIMEOUT t]]]
+    // [BATCHSIZE n [MINBATCHSIZE m [MINBATCHTIMEOUT t]] | [LATENCYTARGET l]]
     // [INPUTS <input_count> name1 name2 ... OUTPUTS <output_count> name1 name2 ...]
     // BLOB model_blob
 
@@ -62,18 +63,36 @@ void RAI_AOFRewriteModel(RedisModuleIO *aof, RedisModuleString *key, void *value
                                 RedisModule_CreateString(NULL, buffer + i * chunk_size, chunk_len));
     }
 
-    if (buffer) {
+    if (owned && buffer) {
         RedisModule_Free(buffer);
     }
 
     const char *backendstr = RAI_GetBackendName(model->backend);
 
+    // The static (MINBATCHSIZE/MINBATCHTIMEOUT) and the adaptive (LATENCYTARGET) batching
+    // options are mutually exclusive, so only the ones in use are emitted.
+    array_new_on_stack(RedisModuleString *, 6, batching_);
+    batching_ = array_append(batching_, RedisModule_CreateString(NULL, "BATCHSIZE", 9));
+    batching_ =
+        array_append(batching_, RedisModule_CreateStringFromLongLong(NULL, model->opts.batchsize));
+    if (model->opts.latencytarget > 0) {
+        batching_ = array_append(batching_, RedisModule_CreateString(NULL, "LATENCYTARGET", 13));
+        batching_ = array_append(
+            batching_, RedisModule_CreateStringFromLongLong(NULL, model->opts.latencytarget));
+    } else {
+        batching_ = array_append(batching_, RedisModule_CreateString(NULL, "MINBATCHSIZE", 12));
+        batching_ = array_append(
+            batching_, RedisModule_CreateStringFromLongLong(NULL, model->opts.minbatchsize));
+        batching_ = array_append(batching_, RedisModule_CreateString(NULL, "MINBATCHTIMEOUT", 15));
+        batching_ = array_append(
+            batching_, RedisModule_CreateStringFromLongLong(NULL, model->opts.minbatchtimeout));
+    }
+    const size_t nbatching = array_len(batching_);
+
     if (model->backend != RAI_BACKEND_TENSORFLOW) {
 
-        RedisModule_EmitAOF(aof, "AI.MODELSTORE", "scccsclclclcv", key, backendstr,
-                            model->devicestr, "TAG", model->tag, "BATCHSIZE", model->opts.batchsize,
-                            "MINBATCHSIZE", model->opts.minbatchsize, "MINBATCHTIMEOUT",
-                            model->opts.minbatchtimeout, "BLOB", buffers_, n_chunks);
+        RedisModule_EmitAOF(aof, "AI.MODELSTORE", "scccsvcv", key, backendstr, model->devicestr,
+                            "TAG", model->tag, batching_, nbatching, "BLOB", buffers_, n_chunks);
     } else {
         // For TF backend, the command should contain INPUTS and OUTPUTS names.
         // Create RedisModuleString* arrays from the char* arrays, so we can send a proper vector
@@ -90,12 +109,10 @@ void RAI_AOFRewriteModel(RedisModuleIO *aof, RedisModuleString *key, void *value
                                                                        strlen(model->outputs[i])));
         }
 
-        RedisModule_EmitAOF(aof, "AI.MODELSTORE", "scccsclclclclvclvcv", key, backendstr,
-                            model->devicestr, "TAG", model->tag, "BATCHSIZE", model->opts.batchsize,
-                            "MINBATCHSIZE", model->opts.minbatchsize, "MINBATCHTIMEOUT",
-                            model->opts.minbatchtimeout, "INPUTS", model->ninputs, inputs_,
-                            model->ninputs, "OUTPUTS", model->noutputs, outputs_, model->noutputs,
-                            "BLOB", buffers_, n_chunks);
+        RedisModule_EmitAOF(aof, "AI.MODELSTORE", "scccsvclvclvcv", key, backendstr,
+                            model->devicestr, "TAG", model->tag, batching_, nbatching, "INPUTS",
+                            model->ninputs, inputs_, model->ninputs, "OUTPUTS", model->noutputs,
+                            outputs_, model->noutputs, "BLOB", buffers_, n_chunks);
 
         for (size_t i = 0; i < model->ninputs; i++) {
             RedisModule_FreeString(NULL, inputs_[i]);
@@ -108,6 +125,11 @@ void RAI_AOFRewriteModel(RedisModuleIO *aof, RedisModuleString *key, void *value
         array_free(outputs_);
     }
 
+    for (size_t i = 0; i < nbatching; i++) {
+        RedisModule_FreeString(NULL, batching_[i]);
+    }
+    array_free(batching_);
+
     for (size_t i = 0; i < n_chunks; i++) {
         RedisModule_FreeString(NULL, buffers_[i]);
     }
@@ -133,6 +155,27 @@ void RAI_AOFRewriteScript(RedisModuleIO *aof, RedisModuleString *key, void *valu
                                                                strlen(script->entryPoints[i])));
         }
     }
+    if (script->batchOpts) {
+        for (size_t i = 0; i < nEntryPoints; i++) {
+            RAI_ScriptBatchOpts *opts = &script->batchOpts[i];
+            if (opts->batchsize == 0) {
+                continue;
+            }
+            args = array_append(args,
+                                RedisModule_CreateString(NULL, "BATCHSIZE", strlen("BATCHSIZE")));
+            args = array_append(args, RedisModule_CreateString(NULL, script->entryPoints[i],
+                                                               strlen(script->entryPoints[i])));
+            args = array_append(args, RedisModule_CreateStringFromLongLong(NULL, opts->batchsize));
+            args = array_append(
+                args, RedisModule_CreateString(NULL, "MINBATCHSIZE", strlen("MINBATCHSIZE")));
+            args =
+                array_append(args, RedisModule_CreateStringFromLongLong(NULL, opts->minbatchsize));
+            args = array_append(
+                args, RedisModule_CreateString(NULL, "MINBATCHTIMEOUT", strlen("MINBATCHTIMEOUT")));
+            args = array_append(args,
+                                RedisModule_CreateStringFromLongLong(NULL, opts->minbatchtimeout));
+        }
+    }
     args = array_append(args, RedisModule_CreateString(NULL, "SOURCE", strlen("SOURCE")));
     args = array_append(
         args, RedisModule_CreateString(NULL, script->scriptdef, strlen(script->scriptdef)));
@@ -9,6 +9,9 @@
 #include "previous/v1/decode_v1.h"
 #include "previous/v2/decode_v2.h"
 #include "previous/v3/decode_v3.h"
+#include "previous/v4/decode_v4.h"
+#include "previous/v5/decode_v5.h"
+#include "previous/v6/decode_v6.h"
 
 void *Decode_PreviousTensor(RedisModuleIO *rdb, int encver) {
     switch (encver) {
@@ -20,6 +23,12 @@ void *Decode_PreviousTensor(RedisModuleIO *rdb, int encver) {
         return RAI_RDBLoadTensor_v2(rdb);
     case 3:
         return RAI_RDBLoadTensor_v3(rdb);
+    case 4:
+        return RAI_RDBLoadTensor_v4(rdb);
+    case 5:
+        return RAI_RDBLoadTensor_v5(rdb);
+    case 6:
+        return RAI_RDBLoadTensor_v6(rdb);
     default:
         assert(false && "Invalid encoding version");
     }
@@ -36,6 +45,12 @@ void *Decode_PreviousModel(RedisModuleIO *rdb, int encver) {
         return RAI_RDBLoadModel_v2(rdb);
     case 3:
         return RAI_RDBLoadModel_v3(rdb);
+    case 4:
+        return RAI_RDBLoadModel_v4(rdb);
+    case 5:
+        return RAI_RDBLoadModel_v5(rdb);
+    case 6:
+        return RAI_RDBLoadModel_v6(rdb);
     default:
         assert(false && "Invalid encoding version");
     }
@@ -52,6 +67,12 @@ void *Decode_PreviousScript(RedisModuleIO *rdb, int encver) {
         return RAI_RDBLoadScript_v2(rdb);
     case 3:
         return RAI_RDBLoadScript_v3(rdb);
+    case 4:
+        return RAI_RDBLoadScript_v4(rdb);
+    case 5:
+        return RAI_RDBLoadScript_v5(rdb);
+    case 6:
+        return RAI_RDBLoadScript_v6(rdb);
     default:
         assert(false && "Invalid encoding version");
     }
@@ -0,0 +1,134 @@
+/*
+ *Copyright Redis Ltd. 2018 - present
+ *Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ *the Server Side Public License v1 (SSPLv1).
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+#include "model_loader.h"
+#include "redis_ai_objects/model.h"
+#include "util/arr.h"
+
+typedef struct ModelLoadJob {
+    RAI_Model *model;  // The pending model (the loader holds a reference to it).
+    RAI_Model *loaded; // The model that the backend built, or NULL on failure.
+    RAI_Error err;
+} ModelLoadJob;
+
+static pthread_mutex_t LoaderLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t LoaderCond = PTHREAD_COND_INITIALIZER;
+static ModelLoadJob **QueuedJobs = NULL;   // Jobs waiting for a worker.
+static ModelLoadJob **FinishedJobs = NULL; // Jobs waiting to be completed on the main thread.
+static size_t PendingJobs = 0;             // Jobs that were scheduled but not finished yet.
+static size_t NumWorkers = 0;
+
+static void *_ModelLoader_WorkerMain(void *arg) {
+    pthread_mutex_lock(&LoaderLock);
+    while (array_len(QueuedJobs) > 0) {
+        ModelLoadJob *job = array_pop(QueuedJobs);
+        pthread_mutex_unlock(&LoaderLock);
+
+        // The pending model is not modified until its loading completes, so its definition can
+        // be read here without the GIL.
+        RAI_Model *model = job->model;
+        job->loaded = RAI_ModelCreate(model->backend, model->devicestr, NULL, model->opts,
+                                      model->ninputs, (const char **)model->inputs,
+                                      model->noutputs, (const char **)model->outputs, model->data,
+                                      model->datalen, &job->err);
+
+        pthread_mutex_lock(&LoaderLock);
+        FinishedJobs = array_append(FinishedJobs, job);
+        PendingJobs--;
+        pthread_cond_signal(&LoaderCond);
+    }
+    // Workers exit once there is nothing left to build, new ones are started on demand.
+    NumWorkers--;
+    pthread_mutex_unlock(&LoaderLock);
+    return NULL;
+}
+
+void ModelLoader_Schedule(RAI_Model *model) {
+    ModelLoadJob *job = RedisModule_Calloc(1, sizeof(*job));
+    job->model = RAI_ModelGetShallowCopy(model);
+
+    pthread_mutex_lock(&LoaderLock);
+    if (!QueuedJobs) {
+        QueuedJobs = array_new(ModelLoadJob *, 10);
+        FinishedJobs = array_new(ModelLoadJob *, 10);
+    }
+    QueuedJobs = array_append(QueuedJobs, job);
+    PendingJobs++;
+
+    // Start another worker, as long as there are jobs that no worker took yet and a CPU to
+    // run it on.
+    long max_workers = sysconf(_SC_NPROCESSORS_ONLN);
+    if (NumWorkers < array_len(QueuedJobs) && (max_workers <= 0 || NumWorkers < max_workers)) {
+        pthread_t thread;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&thread, &attr, _ModelLoader_WorkerMain, NULL) == 0) {
+            NumWorkers++;
+        } else {
+            // The queued jobs are built by the main thread when they are completed.
+            RedisModule_Log(NULL, "warning", "Could not start a thread for loading models");
+        }
+        pthread_attr_destroy(&attr);
+    }
+    pthread_mutex_unlock(&LoaderLock);
+}
+
+void ModelLoader_CompleteAll(RedisModuleCtx *ctx) {
+    pthread_mutex_lock(&LoaderLock);
+    if (!QueuedJobs) {
+        pthread_mutex_unlock(&LoaderLock);
+        return;
+    }
+    if (NumWorkers == 0 && array_len(QueuedJobs) > 0) {
+        // Scheduling failed to start a worker for these jobs, so build them on this thread.
+        NumWorkers++;
+        pthread_mutex_unlock(&LoaderLock);
+        _ModelLoader_WorkerMain(NULL);
+        pthread_mutex_lock(&LoaderLock);
+    }
+    while (PendingJobs > 0) {
+        pthread_cond_wait(&LoaderCond, &LoaderLock);
+    }
+    ModelLoadJob **jobs = FinishedJobs;
+    FinishedJobs = array_new(ModelLoadJob *, 10);
+    pthread_mutex_unlock(&LoaderLock);
+
+    size_t failed = 0;
+    for (size_t i = 0; i < array_len(jobs); i++) {
+        ModelLoadJob *job = jobs[i];
+        if (!job->loaded) {
+            RedisModule_Log(ctx, "warning",
+                            "Could not load model %s (store it again or delete it): %s",
+                            RedisModule_StringPtrLen(job->model->info->key, NULL),
+                            job->err.detail ? job->err.detail : "unknown error");
+            failed++;
+        }
+        RAI_ModelCompleteLoading(job->model, job->loaded);
+        RAI_ClearError(&job->err);
+
+        // If the model was removed from the keyspace meanwhile, this frees it.
+        RAI_Error err = {0};
+        RAI_ModelFree(job->model, &err);
+        RAI_ClearError(&err);
+        RedisModule_Free(job);
+    }
+    if (array_len(jobs) > 0) {
+        RedisModule_Log(ctx, "notice", "Loaded %zu models from RDB (%zu failed)",
+                        array_len(jobs) - failed, failed);
+    }
+    array_free(jobs);
+}
+
+void ModelLoader_OnLoadingEvent(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t subevent,
+                                void *data) {
+    if (subevent == REDISMODULE_SUBEVENT_LOADING_ENDED ||
+        subevent == REDISMODULE_SUBEVENT_LOADING_FAILED) {
+        ModelLoader_CompleteAll(ctx);
+    }
+}
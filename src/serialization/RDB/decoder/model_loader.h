@@ -0,0 +1,46 @@
+/*
+ *Copyright Redis Ltd. 2018 - present
+ *Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ *the Server Side Public License v1 (SSPLv1).
+ */
+
+/**
+ * model_loader.h
+ *
+ * Builds the backend models of the models that are decoded while loading the
+ * dataset from RDB. Instead of creating the backend sessions one after the
+ * other inside the RDB load path, the decoder stores a pending model (see
+ * RAI_ModelCreatePending) and schedules it here. The sessions are created in
+ * parallel on worker threads while the rest of the RDB is being decoded, and
+ * the models are completed once the server finishes loading, before it starts
+ * serving clients.
+ */
+
+#pragma once
+
+#include "redismodule.h"
+#include "redis_ai_objects/model_struct.h"
+
+/**
+ * Schedules building the backend model of a model in the RAI_MODEL_LOADING
+ * state on a worker thread. The loader holds a reference to the model until
+ * loading completes. Must be called from the main thread.
+ *
+ * @param model model created by RAI_ModelCreatePending
+ */
+void ModelLoader_Schedule(RAI_Model *model);
+
+/**
+ * Waits for the scheduled models to be built, and completes their loading (see
+ * RAI_ModelCompleteLoading). Must be called from the main thread.
+ *
+ * @param ctx Context in which Redis modules operate
+ */
+void ModelLoader_CompleteAll(RedisModuleCtx *ctx);
+
+/**
+ * Server event callback for RedisModuleEvent_Loading, which completes the
+ * scheduled models when loading the dataset ends (or fails).
+ */
+void ModelLoader_OnLoadingEvent(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t subevent,
+                                void *data);
@@ -185,7 +185,7 @@ void *RAI_RDBLoadScript_v3(RedisModuleIO *io) {
     }
 
     RAI_Script *script = RAI_ScriptCompile(devicestr, tag, scriptdef, (const char **)entryPoints,
-                                           nEntryPoints, &err);
+                                           nEntryPoints, NULL, &err);
 
     if (err.code == RAI_EBACKENDNOTLOADED) {
         RedisModuleCtx *ctx = RedisModule_GetContextFromIO(io);
@@ -197,7 +197,7 @@ void *RAI_RDBLoadScript_v3(RedisModuleIO *io) {
         }
         RAI_ClearError(&err);
         script = RAI_ScriptCompile(devicestr, tag, scriptdef, (const char **)entryPoints,
-                                   nEntryPoints, &err);
+                                   nEntryPoints, NULL, &err);
     }
 
     if (err.code != RAI_OK) {
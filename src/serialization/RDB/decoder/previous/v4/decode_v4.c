@@ -5,7 +5,7 @@
  */
 
 #include "decode_v4.h"
-#include "../../previous/v3/decode_v3.h"
+#include "../v3/decode_v3.h"
 #include "assert.h"
 
 /**
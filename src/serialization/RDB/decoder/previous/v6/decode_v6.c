@@ -0,0 +1,182 @@
+/*
+ *Copyright Redis Ltd. 2018 - present
+ *Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ *the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "decode_v6.h"
+#include "../v5/decode_v5.h"
+#include "execution/run_queue_info.h"
+#include "serialization/RDB/decoder/model_loader.h"
+
+/**
+ * In case of IO errors, the default return values are:
+ * numbers - 0
+ * strings - null
+ * So only when it is necessary check for IO errors.
+ */
+
+void *RAI_RDBLoadTensor_v6(RedisModuleIO *io) { return RAI_RDBLoadTensor_v5(io); }
+
+void *RAI_RDBLoadModel_v6(RedisModuleIO *io) {
+
+    char *devicestr = NULL;
+    RedisModuleString *tag = NULL;
+    size_t ninputs = 0;
+    const char **inputs = NULL;
+    size_t noutputs = 0;
+    const char **outputs = NULL;
+    char *buffer = NULL;
+
+    RAI_Backend backend = RedisModule_LoadUnsigned(io);
+    devicestr = RedisModule_LoadStringBuffer(io, NULL);
+    tag = RedisModule_LoadString(io);
+
+    const size_t batchsize = RedisModule_LoadUnsigned(io);
+    const size_t minbatchsize = RedisModule_LoadUnsigned(io);
+    const size_t minbatchtimeout = RedisModule_LoadUnsigned(io);
+    const size_t latencytarget = RedisModule_LoadUnsigned(io);
+    // The XNNPACK flag is no longer supported, so it is ignored.
+    RedisModule_LoadUnsigned(io);
+
+    ninputs = RedisModule_LoadUnsigned(io);
+    if (RedisModule_IsIOError(io))
+        goto cleanup;
+
+    inputs = RedisModule_Alloc(ninputs * sizeof(char *));
+
+    for (size_t i = 0; i < ninputs; i++) {
+        inputs[i] = RedisModule_LoadStringBuffer(io, NULL);
+    }
+
+    noutputs = RedisModule_LoadUnsigned(io);
+    if (RedisModule_IsIOError(io))
+        goto cleanup;
+
+    outputs = RedisModule_Alloc(noutputs * sizeof(char *));
+
+    for (size_t i = 0; i < noutputs; i++) {
+        outputs[i] = RedisModule_LoadStringBuffer(io, NULL);
+    }
+
+    RAI_ModelOpts opts = {
+        .batchsize = batchsize,
+        .minbatchsize = minbatchsize,
+        .minbatchtimeout = minbatchtimeout,
+        .latencytarget = latencytarget,
+        .backends_intra_op_parallelism = Config_GetBackendsIntraOpParallelism(),
+        .backends_inter_op_parallelism = Config_GetBackendsInterOpParallelism(),
+    };
+
+    size_t len = RedisModule_LoadUnsigned(io);
+    if (RedisModule_IsIOError(io))
+        goto cleanup;
+
+    buffer = RedisModule_Alloc(len);
+    const size_t n_chunks = RedisModule_LoadUnsigned(io);
+    long long chunk_offset = 0;
+    for (size_t i = 0; i < n_chunks; i++) {
+        size_t chunk_len;
+        char *chunk_buffer = RedisModule_LoadStringBuffer(io, &chunk_len);
+        if (RedisModule_IsIOError(io))
+            goto cleanup;
+        memcpy(buffer + chunk_offset, chunk_buffer, chunk_len);
+        chunk_offset += chunk_len;
+        RedisModule_Free(chunk_buffer);
+    }
+
+    RedisModuleCtx *ctx = RedisModule_GetContextFromIO(io);
+    RAI_Model *model = NULL;
+    // While loading the dataset, the backend model is built in the background, so that the
+    // sessions of all the models in the RDB are created in parallel (see model_loader.h).
+    const bool build_in_background =
+        RedisModule_GetContextFlags(ctx) & REDISMODULE_CTX_FLAGS_LOADING;
+    RAI_Error err = {0};
+    if (build_in_background) {
+        if (!RAI_IsBackendLoaded(backend) &&
+            RAI_LoadDefaultBackend(ctx, backend) != REDISMODULE_OK) {
+            RedisModule_Log(ctx, "warning", "Could not load default backend");
+            goto cleanup;
+        }
+        model = RAI_ModelCreatePending(backend, devicestr, tag, opts, ninputs, inputs, noutputs,
+                                       outputs, buffer, len);
+        buffer = NULL; // The pending model owns it.
+    } else {
+        model = RAI_ModelCreate(backend, devicestr, tag, opts, ninputs, inputs, noutputs, outputs,
+                                buffer, len, &err);
+    }
+
+    if (err.code == RAI_EBACKENDNOTLOADED) {
+        int ret = RAI_LoadDefaultBackend(ctx, backend);
+        if (ret == REDISMODULE_ERR) {
+            RedisModule_Log(ctx, "warning", "Could not load default backend");
+            RAI_ClearError(&err);
+            goto cleanup;
+        }
+        RAI_ClearError(&err);
+        model = RAI_ModelCreate(backend, devicestr, tag, opts, ninputs, inputs, noutputs, outputs,
+                                buffer, len, &err);
+    }
+
+    if (err.code != RAI_OK) {
+        RedisModule_Log(ctx, "warning", "%s", err.detail);
+        RAI_ClearError(&err);
+        goto cleanup;
+    }
+
+    RedisModuleString *stats_keystr =
+        RedisModule_CreateStringFromString(ctx, RedisModule_GetKeyNameFromIO(io));
+
+    RAI_RunStats *stats = RAI_StatsCreate(stats_keystr, RAI_MODEL, backend, devicestr, tag);
+    RAI_StatsStoreEntry(stats_keystr, stats);
+    model->info = stats;
+
+    for (size_t i = 0; i < ninputs; i++) {
+        RedisModule_Free((void *)inputs[i]);
+    }
+    RedisModule_Free(inputs);
+    for (size_t i = 0; i < noutputs; i++) {
+        RedisModule_Free((void *)outputs[i]);
+    }
+    RedisModule_Free(outputs);
+    RedisModule_Free(buffer);
+    RedisModule_Free(devicestr);
+    RedisModule_FreeString(NULL, stats_keystr);
+    RedisModule_FreeString(NULL, tag);
+
+    if (!RunQueue_IsExists(model->devicestr)) {
+        RunQueue_Create(model->devicestr);
+    }
+    if (build_in_background) {
+        ModelLoader_Schedule(model);
+    }
+
+    return model;
+
+cleanup:
+    if (devicestr)
+        RedisModule_Free(devicestr);
+    if (tag)
+        RedisModule_FreeString(NULL, tag);
+    if (inputs) {
+        for (size_t i = 0; i < ninputs; i++) {
+            RedisModule_Free((void *)inputs[i]);
+        }
+        RedisModule_Free(inputs);
+    }
+
+    if (outputs) {
+        for (size_t i = 0; i < noutputs; i++) {
+            RedisModule_Free((void *)outputs[i]);
+        }
+        RedisModule_Free(outputs);
+    }
+
+    if (buffer)
+        RedisModule_Free(buffer);
+
+    RedisModule_LogIOError(io, "error", "Experienced a short read while reading a model from RDB");
+    return NULL;
+}
+
+void *RAI_RDBLoadScript_v6(RedisModuleIO *io) { return RAI_RDBLoadScript_v5(io); }
@@ -4,9 +4,9 @@
  *the Server Side Public License v1 (SSPLv1).
  */
 
-#include "encode_v4.h"
+#include "encode_v7.h"
 
-void RAI_RDBSaveTensor_v4(RedisModuleIO *io, void *value) {
+void RAI_RDBSaveTensor_v7(RedisModuleIO *io, void *value) {
     RAI_Tensor *tensor = (RAI_Tensor *)value;
 
     RedisModule_SaveUnsigned(io, tensor->tensor.dl_tensor.dtype.code);
@@ -19,7 +19,7 @@ void RAI_RDBSaveTensor_v4(RedisModuleIO *io, void *value) {
     }
 
     size_t size = RAI_TensorByteSize(tensor);
-    RedisModule_SaveStringBuffer(io, tensor->tensor.dl_tensor.data, size);
+    RedisModule_SaveStringBuffer(io, RAI_TensorData(tensor), size);
 
     if (tensor->tensor.dl_tensor.dtype.code == kDLString) {
         for (size_t i = 0; i < RAI_TensorLength(tensor); i++) {
@@ -28,19 +28,20 @@ void RAI_RDBSaveTensor_v4(RedisModuleIO *io, void *value) {
     }
 }
 
-void RAI_RDBSaveModel_v4(RedisModuleIO *io, void *value) {
+void RAI_RDBSaveModel_v7(RedisModuleIO *io, void *value) {
     RAI_Model *model = (RAI_Model *)value;
     char *buffer = NULL;
     size_t len = 0;
+    bool owned;
     RAI_Error err = {0};
 
-    int ret = RAI_ModelSerialize(model, &buffer, &len, &err);
+    int ret = RAI_ModelGetBlob(model, &buffer, &len, &owned, &err);
 
     if (err.code != RAI_OK) {
         RedisModuleCtx *stats_ctx = RedisModule_GetContextFromIO(io);
         printf("ERR: %s\n", err.detail);
         RAI_ClearError(&err);
-        if (buffer) {
+        if (owned && buffer) {
             RedisModule_Free(buffer);
         }
         return;
@@ -52,6 +53,7 @@ void RAI_RDBSaveModel_v4(RedisModuleIO *io, void *value) {
     RedisModule_SaveUnsigned(io, model->opts.batchsize);
     RedisModule_SaveUnsigned(io, model->opts.minbatchsize);
     RedisModule_SaveUnsigned(io, model->opts.minbatchtimeout);
+    RedisModule_SaveUnsigned(io, model->opts.latencytarget);
     RedisModule_SaveUnsigned(io, model->ninputs);
     for (size_t i = 0; i < model->ninputs; i++) {
         RedisModule_SaveStringBuffer(io, model->inputs[i], strlen(model->inputs[i]) + 1);
@@ -69,12 +71,12 @@ void RAI_RDBSaveModel_v4(RedisModuleIO *io, void *value) {
         RedisModule_SaveStringBuffer(io, buffer + i * chunk_size, chunk_len);
     }
 
-    if (buffer) {
+    if (owned && buffer) {
         RedisModule_Free(buffer);
     }
 }
 
-void RAI_RDBSaveScript_v4(RedisModuleIO *io, void *value) {
+void RAI_RDBSaveScript_v7(RedisModuleIO *io, void *value) {
     RAI_Script *script = (RAI_Script *)value;
 
     RedisModule_SaveStringBuffer(io, script->devicestr, strlen(script->devicestr) + 1);
@@ -86,5 +88,12 @@ void RAI_RDBSaveScript_v4(RedisModuleIO *io, void *value) {
     for (size_t i = 0; i < nEntryPoints; i++) {
         RedisModule_SaveStringBuffer(io, script->entryPoints[i],
                                      strlen(script->entryPoints[i]) + 1);
+        RAI_ScriptBatchOpts opts = {0};
+        if (script->batchOpts) {
+            opts = script->batchOpts[i];
+        }
+        RedisModule_SaveUnsigned(io, opts.batchsize);
+        RedisModule_SaveUnsigned(io, opts.minbatchsize);
+        RedisModule_SaveUnsigned(io, opts.minbatchtimeout);
     }
 }
@@ -0,0 +1,122 @@
+/*
+ *Copyright Redis Ltd. 2018 - present
+ *Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ *the Server Side Public License v1 (SSPLv1).
+ */
+
+#include <stdbool.h>
+#include "histogram.h"
+#include "redismodule.h"
+
+static unsigned int NextShard;
+static __thread int ThreadShard = -1;
+
+static size_t _HistogramBucketIndex(unsigned long long value) {
+    if (value < HISTOGRAM_SUB_BUCKETS) {
+        return value;
+    }
+    unsigned int exp = 63 - __builtin_clzll(value);
+    if (exp >= HISTOGRAM_MAX_EXP) {
+        return HISTOGRAM_BUCKETS - 1;
+    }
+    unsigned int shift = exp - HISTOGRAM_SUB_BUCKET_BITS;
+    size_t sub_bucket = (value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1);
+    return (shift + 1) * HISTOGRAM_SUB_BUCKETS + sub_bucket;
+}
+
+/**
+ * @brief Returns the highest value that is recorded in the given bucket.
+ */
+static unsigned long long _HistogramBucketHighestValue(size_t index) {
+    if (index < HISTOGRAM_SUB_BUCKETS) {
+        return index;
+    }
+    unsigned int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+    unsigned long long sub_bucket = index % HISTOGRAM_SUB_BUCKETS;
+    return ((HISTOGRAM_SUB_BUCKETS + sub_bucket + 1) << shift) - 1;
+}
+
+static unsigned long long *_HistogramGetShard(RAI_Histogram *histogram) {
+    if (ThreadShard < 0) {
+        ThreadShard = __atomic_fetch_add(&NextShard, 1, __ATOMIC_RELAXED) % HISTOGRAM_SHARDS;
+    }
+    unsigned long long **slot = &histogram->shards[ThreadShard];
+    unsigned long long *shard = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+    if (shard) {
+        return shard;
+    }
+    // Allocate the shard on first use. If another thread (sharing this shard)
+    // allocated it concurrently, use that one instead.
+    unsigned long long *new_shard =
+        RedisModule_Calloc(HISTOGRAM_BUCKETS, sizeof(unsigned long long));
+    if (!__atomic_compare_exchange_n(slot, &shard, new_shard, false, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE)) {
+        RedisModule_Free(new_shard);
+        return shard;
+    }
+    return new_shard;
+}
+
+void RAI_HistogramRecord(RAI_Histogram *histogram, unsigned long long value) {
+    unsigned long long *shard = _HistogramGetShard(histogram);
+    __atomic_add_fetch(&shard[_HistogramBucketIndex(value)], 1, __ATOMIC_RELAXED);
+}
+
+void RAI_HistogramReset(RAI_Histogram *histogram) {
+    for (size_t i = 0; i < HISTOGRAM_SHARDS; i++) {
+        unsigned long long *shard = __atomic_load_n(&histogram->shards[i], __ATOMIC_ACQUIRE);
+        if (!shard) {
+            continue;
+        }
+        for (size_t j = 0; j < HISTOGRAM_BUCKETS; j++) {
+            __atomic_store_n(&shard[j], 0, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+void RAI_HistogramPercentiles(RAI_Histogram *histogram, const double *percentiles,
+                              size_t npercentiles, unsigned long long *values) {
+    unsigned long long *counts =
+        RedisModule_Calloc(HISTOGRAM_BUCKETS, sizeof(unsigned long long));
+    unsigned long long total = 0;
+    for (size_t i = 0; i < HISTOGRAM_SHARDS; i++) {
+        unsigned long long *shard = __atomic_load_n(&histogram->shards[i], __ATOMIC_ACQUIRE);
+        if (!shard) {
+            continue;
+        }
+        for (size_t j = 0; j < HISTOGRAM_BUCKETS; j++) {
+            unsigned long long count = __atomic_load_n(&shard[j], __ATOMIC_RELAXED);
+            counts[j] += count;
+            total += count;
+        }
+    }
+
+    size_t bucket = 0;
+    unsigned long long cumulative = counts[0];
+    for (size_t i = 0; i < npercentiles; i++) {
+        if (total == 0) {
+            values[i] = 0;
+            continue;
+        }
+        // The rank of the value at this percentile (1 based).
+        double exact_rank = percentiles[i] / 100.0 * total;
+        unsigned long long rank = (unsigned long long)exact_rank;
+        if (rank < exact_rank || rank == 0) {
+            rank++;
+        }
+        while (cumulative < rank && bucket < HISTOGRAM_BUCKETS - 1) {
+            cumulative += counts[++bucket];
+        }
+        values[i] = _HistogramBucketHighestValue(bucket);
+    }
+    RedisModule_Free(counts);
+}
+
+void RAI_HistogramFree(RAI_Histogram *histogram) {
+    for (size_t i = 0; i < HISTOGRAM_SHARDS; i++) {
+        if (histogram->shards[i]) {
+            RedisModule_Free(histogram->shards[i]);
+            histogram->shards[i] = NULL;
+        }
+    }
+}
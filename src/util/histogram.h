@@ -0,0 +1,59 @@
+/*
+ *Copyright Redis Ltd. 2018 - present
+ *Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ *the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+/**
+ * A lock-free log-linear (HDR style) histogram of non-negative integer values, such
+ * as latencies in microseconds. Every power of two range is split into
+ * HISTOGRAM_SUB_BUCKETS linear buckets, so that values are recorded with a relative
+ * error of at most 1/HISTOGRAM_SUB_BUCKETS, and values below HISTOGRAM_SUB_BUCKETS
+ * are recorded exactly.
+ *
+ * To avoid contention between threads that record concurrently, the histogram is
+ * split into shards, and every thread records into its own shard (shards are
+ * assigned to threads in a round-robin manner, and allocated on first use). The
+ * shards are merged only when the histogram is read.
+ */
+
+#include <stddef.h>
+
+#define HISTOGRAM_SHARDS         8
+#define HISTOGRAM_SUB_BUCKET_BITS 4
+#define HISTOGRAM_SUB_BUCKETS    (1 << HISTOGRAM_SUB_BUCKET_BITS)
+// Values of 2^HISTOGRAM_MAX_EXP and above are recorded in the last bucket.
+#define HISTOGRAM_MAX_EXP 40
+#define HISTOGRAM_BUCKETS                                                                          \
+    ((HISTOGRAM_MAX_EXP - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+typedef struct RAI_Histogram {
+    unsigned long long *shards[HISTOGRAM_SHARDS];
+} RAI_Histogram;
+
+/**
+ * @brief Record a single value in the histogram. Safe to call concurrently.
+ */
+void RAI_HistogramRecord(RAI_Histogram *histogram, unsigned long long value);
+
+/**
+ * @brief Reset all the counters of the histogram.
+ */
+void RAI_HistogramReset(RAI_Histogram *histogram);
+
+/**
+ * @brief Compute the values at the given percentiles (in the range [0, 100]) of the
+ * recorded values. Every value is reported as the highest value that is equivalent
+ * to it within the histogram's precision, or 0 if nothing was recorded.
+ * @param percentiles array of npercentiles percentiles, in ascending order.
+ * @param values output array of npercentiles values.
+ */
+void RAI_HistogramPercentiles(RAI_Histogram *histogram, const double *percentiles,
+                              size_t npercentiles, unsigned long long *values);
+
+/**
+ * @brief Release the memory held by the histogram (not the histogram struct itself).
+ */
+void RAI_HistogramFree(RAI_Histogram *histogram);
@@ -22,10 +22,8 @@ queue *queueCreate(void) {
     return queue;
 }
 
-void queuePush(queue *queue, void *value) {
+void queuePushItem(queue *queue, queueItem *item) {
 
-    queueItem *item = RedisModule_Calloc(1, sizeof(*item));
-    item->value = value;
     item->next = NULL;
     item->prev = NULL;
 
@@ -39,11 +37,8 @@ void queuePush(queue *queue, void *value) {
     queue->len++;
 }
 
-void queuePushFront(queue *queue, void *value) {
+void queuePushItemFront(queue *queue, queueItem *item) {
 
-    queueItem *item = RedisModule_Calloc(1, sizeof(*item));
-
-    item->value = value;
     item->next = NULL;
     item->prev = NULL;
 
@@ -57,6 +52,20 @@ void queuePushFront(queue *queue, void *value) {
     queue->len++;
 }
 
+void queuePush(queue *queue, void *value) {
+
+    queueItem *item = RedisModule_Calloc(1, sizeof(*item));
+    item->value = value;
+    queuePushItem(queue, item);
+}
+
+void queuePushFront(queue *queue, void *value) {
+
+    queueItem *item = RedisModule_Calloc(1, sizeof(*item));
+    item->value = value;
+    queuePushItemFront(queue, item);
+}
+
 queueItem *queuePop(queue *queue) {
     queueItem *item = queue->front;
     if (item == NULL) {
@@ -112,3 +121,39 @@ void queueRelease(queue *queue) {
     queue->front = queue->back = NULL;
     queue->len = 0;
 }
+
+void queueInboxPush(queueInbox *inbox, queueItem *item) {
+    item->prev = NULL;
+    item->next = __atomic_load_n(&inbox->head, __ATOMIC_RELAXED);
+    // On failure, item->next is updated to the current head, so we can retry.
+    while (!__atomic_compare_exchange_n(&inbox->head, &item->next, item, true, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_RELAXED))
+        ;
+}
+
+bool queueInboxIsEmpty(queueInbox *inbox) {
+    return __atomic_load_n(&inbox->head, __ATOMIC_SEQ_CST) == NULL;
+}
+
+unsigned long queueInboxDrain(queueInbox *inbox, queue *queue) {
+    // Detach all the items at once. Since items are never popped from the inbox
+    // one by one, this is not subject to the ABA problem.
+    queueItem *item = __atomic_exchange_n(&inbox->head, NULL, __ATOMIC_ACQUIRE);
+
+    // The inbox is LIFO, so reverse the detached list to restore the push order.
+    queueItem *reversed = NULL;
+    while (item) {
+        queueItem *next = item->next;
+        item->next = reversed;
+        reversed = item;
+        item = next;
+    }
+    unsigned long n_items = 0;
+    while (reversed) {
+        queueItem *next = reversed->next;
+        queuePushItem(queue, reversed);
+        reversed = next;
+        n_items++;
+    }
+    return n_items;
+}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <pthread.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -26,12 +27,31 @@ typedef struct queue {
     unsigned long len;
 } queue;
 
+/**
+ * A lock-free multi-producer inbox of queue items. Producers push items
+ * concurrently without taking any lock, and a single consumer at a time (that
+ * holds the lock of the target queue) moves all of them at once to the back of
+ * a queue, preserving the order in which they were pushed.
+ */
+typedef struct queueInbox {
+    queueItem *head;
+} queueInbox;
+
 queue *queueCreate(void);
 void queuePush(queue *queue, void *value);
 void queuePushFront(queue *queue, void *value);
+// Intrusive variants of queuePush and queuePushFront - the item is owned by the
+// caller (and its value should be set), so these never allocate. Items that
+// were pushed this way should not be freed after they are popped or evicted.
+void queuePushItem(queue *queue, queueItem *item);
+void queuePushItemFront(queue *queue, queueItem *item);
 queueItem *queuePop(queue *queue);
 queueItem *queueFront(queue *queue);
 queueItem *queueNext(queueItem *item);
 queueItem *queueEvict(queue *queue, queueItem *item);
 unsigned long queueLength(queue *queue);
 void queueRelease(queue *queue);
+
+void queueInboxPush(queueInbox *inbox, queueItem *item);
+bool queueInboxIsEmpty(queueInbox *inbox);
+unsigned long queueInboxDrain(queueInbox *inbox, queue *queue);
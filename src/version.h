@@ -16,4 +16,4 @@
 /* API versions. */
 #define REDISAI_LLAPI_VERSION 1
 
-static const long long REDISAI_ENC_VER = 4;
+static const long long REDISAI_ENC_VER = 7;
@@ -266,7 +266,7 @@ def check_error(env, con, *command, error_type=redis.exceptions.ResponseError):
 
 # Returns a dict with all the fields of a certain section from INFO MODULES command
 def get_info_section(con, section):
-    sections = ['ai_versions', 'ai_git', 'ai_load_time_configs', 'ai_backends_info', 'ai_cpu']
+    sections = ['ai_versions', 'ai_git', 'ai_load_time_configs', 'ai_backends_info', 'ai_cpu', 'ai_queues', 'ai_latency']
     section_ind = [i for i in range(len(sections)) if sections[i] == 'ai_'+section][0]
     return {k.split(":")[0]: k.split(":")[1]
             for k in con.execute_command("INFO MODULES").decode().split("#")[section_ind+2].split()[1:]}
@@ -127,6 +127,16 @@ def test_torch_model_serialization(env):
         env.assertEqual([backend, device, tag, batchsize, minbatchsize, minbatchtimeout, inputs, outputs],
                              [b"TORCH", DEVICE.encode(), b"PT_MINIMAL3", 0, 0, 0, [b"a", b"b"], [b'']])
 
+        # Reinsert the model (with adaptive batching)
+        con.execute_command('AI.MODELSTORE', key_name, 'TORCH', DEVICE, 'TAG', 'PT_MINIMAL4', 'batchsize', 4,
+                            'latencytarget', 50, 'BLOB', torch_model)
+        env.restartAndReload(timeout_sec=300)
+        _, backend, _, device, _, tag, _, batchsize, _, minbatchsize, _ , inputs, _, outputs, _, minbatchtimeout, \
+            _, latencytarget = con.execute_command("AI.MODELGET", key_name, "META")
+        env.assertEqual([backend, device, tag, batchsize, minbatchsize, minbatchtimeout, latencytarget, inputs, outputs],
+                             [b"TORCH", DEVICE.encode(), b"PT_MINIMAL4", 4, 0, 0, 50, [b"a", b"b"], [b'']])
+        torch_model_run(env, key_name)
+
 def torch_script_run(env, script_key):
     con = get_connection(env, script_key)
     con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 2, 2, 'VALUES', 2, 3, 2, 3)
@@ -204,6 +214,29 @@ def test_onnx_serialization(env):
                              [b"ONNX", DEVICE.encode(), b"ONNX_LINEAR_IRIS3", 0, 0, 0, [b'float_input'], [b'variable']])
 
 
+def test_models_rdb_parallel_load(env):
+        # Models that are decoded from RDB are built in parallel, and must all be ready to run once loading ends.
+        con = get_connection(env, '{1}')
+        torch_model = load_file_content("pt-minimal.pt")
+        onnx_model = load_file_content("linear_iris.onnx")
+        torch_keys = ['pt-minimal{1}_%d' % i for i in range(4)]
+        onnx_keys = ['linear_iris{1}_%d' % i for i in range(4)]
+        for key_name in torch_keys:
+            con.execute_command('AI.MODELSTORE', key_name, 'TORCH', DEVICE, 'TAG', key_name, 'BLOB', torch_model)
+        for key_name in onnx_keys:
+            con.execute_command('AI.MODELSTORE', key_name, 'ONNX', DEVICE, 'TAG', key_name, 'BLOB', onnx_model)
+
+        env.assertEqual(con.execute_command('DEBUG', 'RELOAD'), b'OK')
+        for key_name in torch_keys + onnx_keys:
+            _, _, _, _, _, tag = con.execute_command("AI.MODELGET", key_name, "META")[:6]
+            env.assertEqual(tag, key_name.encode())
+        for key_name in torch_keys:
+            torch_model_run(env, key_name)
+        for key_name in onnx_keys:
+            onnx_model_run(env, key_name)
+        env.assertEqual(con.execute_command('AI.MODELDEL', torch_keys[0]), b'OK')
+
+
 def test_tensor_serialization(env):
         key_name = "tensor{1}"
         con = get_connection(env, key_name)
@@ -131,3 +131,92 @@ class test_torch_script_extesions:
                             "Invalid rank for input: X Got: 1 Expected: 2 Please fix either the inputs or the model",
                             'AI.SCRIPTEXECUTE', 'redis_scripts{1}', 'test_model_execute_onnx_bad_input', 'KEYS', 1, "model_onnx{1}",
                             'OUTPUTS', 1, 'y{1}', error_msg_is_substr=True)
+
+    def test_redis_execute_many(self):
+        script = '''
+def execute_many_set_get(tensors: List[Tensor], keys: List[str], args: List[str]):
+    redis.execute_many([["SET", keys[0], args[0]], ["SET", keys[1], args[1]]])
+    replies = redis.execute_many([["GET", keys[0]], ["GET", keys[1]]])
+    values = [int(str(reply)) for reply in replies]
+    return torch.tensor(values)
+
+def execute_many_error(tensors: List[Tensor], keys: List[str], args: List[str]):
+    redis.execute_many([["SET", keys[0], "1"], ["HGET", keys[0], "field"]])
+'''
+        ret = self.con.execute_command('AI.SCRIPTSTORE', 'execute_many_script{1}', DEVICE, 'ENTRY_POINTS', 2,
+                                       'execute_many_set_get', 'execute_many_error', 'SOURCE', script)
+        self.env.assertEqual(ret, b'OK')
+
+        self.con.execute_command('AI.SCRIPTEXECUTE', 'execute_many_script{1}', 'execute_many_set_get',
+                                 'KEYS', 2, 'x{1}', 'z{1}', 'ARGS', 2, 3, 4, 'OUTPUTS', 1, 'y{1}')
+        y = self.con.execute_command('AI.TENSORGET', 'y{1}', 'meta', 'VALUES')
+        self.env.assertEqual(y, [b"dtype", b"INT64", b"shape", [2], b"values", [3, 4]])
+
+        check_error_message(self.env, self.con, "Redis command returned an error: "
+                                                "WRONGTYPE Operation against a key holding the wrong kind of value",
+                            'AI.SCRIPTEXECUTE', 'execute_many_script{1}', 'execute_many_error', 'KEYS', 1, "x{1}",
+                            error_msg_is_substr=True)
+
+    def test_tensor_get_set(self):
+        script = '''
+def tensor_get_set(tensors: List[Tensor], keys: List[str], args: List[str]):
+    a = redisAI.tensor_get(keys[0])
+    redisAI.tensor_set(keys[1], a * 2)
+    return redisAI.tensor_get(keys[1]) + 1
+
+def tensor_set_transposed(tensors: List[Tensor], keys: List[str], args: List[str]):
+    redisAI.tensor_set(keys[0], tensors[0].t())
+
+def tensor_get_modify(tensors: List[Tensor], keys: List[str], args: List[str]):
+    a = redisAI.tensor_get(keys[0])
+    a.add_(1)
+    return a
+
+def tensor_set_modify(tensors: List[Tensor], keys: List[str], args: List[str]):
+    a = tensors[0] * 2
+    redisAI.tensor_set(keys[0], a)
+    a.add_(1)
+    return a
+'''
+        ret = self.con.execute_command('AI.SCRIPTSTORE', 'tensor_get_set_script{1}', DEVICE, 'ENTRY_POINTS', 4,
+                                       'tensor_get_set', 'tensor_set_transposed', 'tensor_get_modify',
+                                       'tensor_set_modify', 'SOURCE', script)
+        self.env.assertEqual(ret, b'OK')
+        self.con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 2, 2, 'VALUES', 1, 2, 3, 4)
+
+        self.con.execute_command('AI.SCRIPTEXECUTE', 'tensor_get_set_script{1}', 'tensor_get_set',
+                                 'KEYS', 2, 'a{1}', 'b{1}', 'OUTPUTS', 1, 'c{1}')
+        b = self.con.execute_command('AI.TENSORGET', 'b{1}', 'meta', 'VALUES')
+        self.env.assertEqual(b, [b"dtype", b"FLOAT", b"shape", [2, 2], b"values", [b'2', b'4', b'6', b'8']])
+        c = self.con.execute_command('AI.TENSORGET', 'c{1}', 'VALUES')
+        self.env.assertEqual(c, [b'3', b'5', b'7', b'9'])
+
+        # A non contiguous tensor is stored in row-major order.
+        self.con.execute_command('AI.SCRIPTEXECUTE', 'tensor_get_set_script{1}', 'tensor_set_transposed',
+                                 'KEYS', 1, 'd{1}', 'INPUTS', 1, 'a{1}')
+        d = self.con.execute_command('AI.TENSORGET', 'd{1}', 'VALUES')
+        self.env.assertEqual(d, [b'1', b'3', b'2', b'4'])
+
+        # Modifying a tensor that was read from a key does not change the key.
+        self.con.execute_command('AI.SCRIPTEXECUTE', 'tensor_get_set_script{1}', 'tensor_get_modify',
+                                 'KEYS', 1, 'a{1}', 'OUTPUTS', 1, 'g{1}')
+        g = self.con.execute_command('AI.TENSORGET', 'g{1}', 'VALUES')
+        self.env.assertEqual(g, [b'2', b'3', b'4', b'5'])
+        a = self.con.execute_command('AI.TENSORGET', 'a{1}', 'VALUES')
+        self.env.assertEqual(a, [b'1', b'2', b'3', b'4'])
+
+        # Modifying a tensor after it is stored does not change the stored tensor.
+        self.con.execute_command('AI.SCRIPTEXECUTE', 'tensor_get_set_script{1}', 'tensor_set_modify',
+                                 'KEYS', 1, 'e{1}', 'INPUTS', 1, 'a{1}', 'OUTPUTS', 1, 'f{1}')
+        e = self.con.execute_command('AI.TENSORGET', 'e{1}', 'VALUES')
+        self.env.assertEqual(e, [b'2', b'4', b'6', b'8'])
+        f = self.con.execute_command('AI.TENSORGET', 'f{1}', 'VALUES')
+        self.env.assertEqual(f, [b'3', b'5', b'7', b'9'])
+
+        check_error_message(self.env, self.con, "tensor key is empty",
+                            'AI.SCRIPTEXECUTE', 'tensor_get_set_script{1}', 'tensor_get_set',
+                            'KEYS', 2, 'missing{1}', 'b{1}', 'OUTPUTS', 1, 'c{1}', error_msg_is_substr=True)
+        self.con.execute_command('SET', 'not_tensor{1}', 'bar')
+        check_error_message(self.env, self.con, "WRONGTYPE Operation against a key holding the wrong kind of value",
+                            'AI.SCRIPTEXECUTE', 'tensor_get_set_script{1}', 'tensor_get_set',
+                            'KEYS', 2, 'a{1}', 'not_tensor{1}', 'OUTPUTS', 1, 'c{1}', error_msg_is_substr=True)
@@ -2,6 +2,9 @@
 # Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
 # the Server Side Public License v1 (SSPLv1).
 
+import shutil
+import tempfile
+
 from includes import *
 from tests_llapi import with_test_module
 
@@ -52,10 +55,19 @@ def test_modelstore_errors(env):
     check_error_message(env, con, "Invalid argument for MINBATCHTIMEOUT",
                         'AI.MODELSTORE', 'm{1}', 'TORCH', DEVICE, 'BATCHSIZE', 2, 'MINBATCHSIZE', 2,
                         'MINBATCHTIMEOUT', 'bad_timeout', 'BLOB', model_pb)
+    check_error_message(env, con, "Invalid argument for LATENCYTARGET",
+                        'AI.MODELSTORE', 'm{1}', 'TORCH', DEVICE, 'BATCHSIZE', 2, 'LATENCYTARGET', 0, 'BLOB', model_pb)
+    check_error_message(env, con, "LATENCYTARGET specified without BATCHSIZE",
+                        'AI.MODELSTORE', 'm{1}', 'TORCH', DEVICE, 'LATENCYTARGET', 10, 'BLOB', model_pb)
+    check_error_message(env, con, "LATENCYTARGET cannot be specified together with MINBATCHSIZE",
+                        'AI.MODELSTORE', 'm{1}', 'TORCH', DEVICE, 'BATCHSIZE', 2, 'MINBATCHSIZE', 2,
+                        'LATENCYTARGET', 10, 'BLOB', model_pb)
 
     # INPUTS and OUTPUTS args are relevant only for TF.
     check_error_message(env, con, "INPUTS argument should not be specified for this backend",
                         'AI.MODELSTORE', 'm{1}', 'TORCH', DEVICE, 'INPUTS', 2, 'a', 'b', 'OUTPUTS', 1, 'c', 'BLOB', model_pb)
+    check_error_message(env, con, "MODEL_REPOSITORY is not configured",
+                        'AI.MODELSTORE', 'm{1}', 'TORCH', DEVICE, 'PATH', 'pt-minimal.pt')
 
     # Check for existence and validity of blob
     check_error_message(env, con, "Insufficient arguments, missing model BLOB",
@@ -66,6 +78,41 @@ def test_modelstore_errors(env):
                         'AI.MODELSTORE', 'm{1}', 'TORCH', DEVICE, 'BATCHSIZE', 2, 'BLOB')
 
 
+def test_modelstore_blocking_and_transaction(env):
+    if not TEST_PT:
+        env.debugPrint("skipping {} since TEST_PT=0".format(sys._getframe().f_code.co_name), force=True)
+        return
+
+    con = get_connection(env, '{1}')
+    model_pb = load_file_content('pt-minimal.pt')
+
+    # The model is created in the background, while other clients are served.
+    def store():
+        con = get_connection(env, '{1}')
+        for i in range(5):
+            ret = con.execute_command('AI.MODELSTORE', 'm{1}', 'TORCH', DEVICE, 'TAG', 'v' + str(i),
+                                      'BLOB', model_pb)
+            env.assertEqual(ret, b'OK')
+    t = threading.Thread(target=store)
+    t.start()
+    while t.is_alive():
+        env.assertEqual(con.execute_command('PING'), True)
+    t.join()
+    ensureSlaveSynced(con, env)
+    env.assertEqual(con.execute_command('AI.MODELGET', 'm{1}', 'META')[5], b'v4')
+
+    # Clients cannot be blocked within a transaction, so the model is created synchronously.
+    pipe = con.pipeline(transaction=True)
+    pipe.execute_command('AI.MODELSTORE', 'm2{1}', 'TORCH', DEVICE, 'BLOB', model_pb)
+    pipe.execute_command('AI.MODELGET', 'm2{1}', 'META')
+    ret = pipe.execute()
+    env.assertEqual(ret[0], b'OK')
+    env.assertEqual(ret[1][1], b'TORCH')
+    con.execute_command('SET', 'NOT_MODEL{1}', 'BAR')
+    check_error_message(env, con, "WRONGTYPE Operation against a key holding the wrong kind of value",
+                        'AI.MODELSTORE', 'NOT_MODEL{1}', 'TORCH', DEVICE, 'BLOB', model_pb)
+
+
 def test_modelget(env):
     if not TEST_TF:
         env.debugPrint("Skipping test since TF is not available", force=True)
@@ -94,6 +141,73 @@ def test_modelget(env):
     env.assertEqual(blob, model_pb)
 
 
+def test_modelstore_from_path():
+    test_data_path = os.path.join(os.path.dirname(__file__), 'test_data')
+    env = Env(moduleArgs='MODEL_REPOSITORY ' + test_data_path)
+    if not TEST_TF:
+        env.debugPrint("Skipping test since TF is not available", force=True)
+        return
+
+    con = get_connection(env, '{1}')
+    ret = con.execute_command('AI.MODELSTORE', 'm{1}', 'TF', DEVICE, 'INPUTS', 2, 'a', 'b', 'OUTPUTS', 1, 'mul',
+                              'PATH', 'graph.pb')
+    env.assertEqual(ret, b'OK')
+    blob = con.execute_command('AI.MODELGET', 'm{1}', 'BLOB')
+    env.assertEqual(blob, load_file_content('graph.pb'))
+
+    con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 2, 2, 'VALUES', 2, 3, 2, 3)
+    con.execute_command('AI.TENSORSET', 'b{1}', 'FLOAT', 2, 2, 'VALUES', 2, 3, 2, 3)
+    con.execute_command('AI.MODELEXECUTE', 'm{1}', 'INPUTS', 2, 'a{1}', 'b{1}', 'OUTPUTS', 1, 'c{1}')
+    values = con.execute_command('AI.TENSORGET', 'c{1}', 'VALUES')
+    env.assertEqual(values, [b'4', b'9', b'4', b'9'])
+
+    # Only files under the model repository can be loaded.
+    check_error_message(env, con, "Invalid model PATH",
+                        'AI.MODELSTORE', 'm{1}', 'TF', DEVICE, 'INPUTS', 2, 'a', 'b', 'OUTPUTS', 1, 'mul',
+                        'PATH', '../tests_commands.py')
+    check_error_message(env, con, "Invalid model PATH",
+                        'AI.MODELSTORE', 'm{1}', 'TF', DEVICE, 'INPUTS', 2, 'a', 'b', 'OUTPUTS', 1, 'mul',
+                        'PATH', 'no_such_model.pb')
+    check_error_message(env, con, "PATH requires a single model file path",
+                        'AI.MODELSTORE', 'm{1}', 'TF', DEVICE, 'INPUTS', 2, 'a', 'b', 'OUTPUTS', 1, 'mul',
+                        'PATH', 'graph.pb', 'graph.pb')
+    env.assertEqual(con.execute_command('AI.CONFIG', 'GET', 'MODEL_REPOSITORY'),
+                    os.path.realpath(test_data_path).encode())
+
+
+def test_modelstore_from_path_replication():
+    model_repository = tempfile.mkdtemp()
+    shutil.copy(os.path.join(os.path.dirname(__file__), 'test_data', 'graph.pb'), model_repository)
+    env = Env(moduleArgs='MODEL_REPOSITORY ' + model_repository)
+    if not TEST_TF:
+        env.debugPrint("Skipping test since TF is not available", force=True)
+        return
+    if not env.useSlaves:
+        env.debugPrint("Skipping test since there are no replicas", force=True)
+        return
+
+    con = get_connection(env, '{1}')
+
+    # The replica does not process the replication stream until the model file is removed,
+    # so it can store the model only if it gets the model blob rather than its path.
+    def sleep_replica():
+        env.getSlaveConnection().execute_command('DEBUG', 'SLEEP', 1)
+
+    t = threading.Thread(target=sleep_replica)
+    t.start()
+    time.sleep(0.2)
+    ret = con.execute_command('AI.MODELSTORE', 'm{1}', 'TF', DEVICE, 'INPUTS', 2, 'a', 'b', 'OUTPUTS', 1, 'mul',
+                              'PATH', 'graph.pb')
+    env.assertEqual(ret, b'OK')
+    shutil.rmtree(model_repository)
+    t.join()
+
+    ensureSlaveSynced(con, env)
+    con2 = env.getSlaveConnection()
+    blob = con2.execute_command('AI.MODELGET', 'm{1}', 'BLOB')
+    env.assertEqual(blob, load_file_content('graph.pb'))
+
+
 def test_modelexecute_errors(env):
     if not TEST_TF:
         env.debugPrint("Skipping test since TF is not available", force=True)
@@ -312,7 +312,7 @@ def test_info_command(env):
     load_time_configs = get_info_section(con, 'load_time_configs')
     env.assertEqual(list(load_time_configs.keys()), ['ai_threads_per_queue', 'ai_inter_op_parallelism',
                                                      'ai_intra_op_parallelism', 'ai_model_execution_timeout',
-                                                     'ai_backend_memory_limit'])
+                                                     'ai_backend_memory_limit', 'ai_model_session_pool_size'])
     # minimum cpu properties
     cpu = get_info_section(con, 'cpu')
     env.assertTrue('ai_self_used_cpu_sys' in cpu.keys())
@@ -320,6 +320,12 @@ def test_info_command(env):
     env.assertTrue('ai_children_used_cpu_sys' in cpu.keys())
     env.assertTrue('ai_children_used_cpu_user' in cpu.keys())
     env.assertTrue('ai_queue_CPU_bthread_n1_used_cpu_total' in cpu.keys())
+    queues = get_info_section(con, 'queues')
+    for metric in ['depth', 'enqueued', 'dequeued', 'avg_wait_us', 'max_wait_us', 'busy_us',
+                   'batches', 'avg_batch_fill']:
+        env.assertTrue('ai_queue_CPU_' + metric in queues.keys())
+    # The counters are cumulative, so reading them does not reset them.
+    env.assertEqual(get_info_section(con, 'queues'), queues)
 
 
 def test_string_tensor(env):
@@ -253,3 +253,29 @@ def test_dag_with_string_tensor(env):
                               '|>', 'AI.TENSORGET', 'out_tensor{1}', 'VALUES')
 
     env.assertEqual(ret, [b'OK', b'OK', [b'input11', b'input12', b'input21', b'input22']])
+
+
+def test_dag_independent_ops_parallel():
+    env = Env(moduleArgs='THREADS_PER_QUEUE 4')
+    if not TEST_TF:
+        env.debugPrint("skipping {} since TEST_TF=0".format(sys._getframe().f_code.co_name), force=True)
+        return
+
+    con = get_connection(env, '{1}')
+    model_pb = load_file_content('graph.pb')
+    ret = con.execute_command('AI.MODELSTORE', 'm{1}', 'TF', DEVICE,
+                              'INPUTS', 2, 'a', 'b', 'OUTPUTS', 1, 'mul', 'BLOB', model_pb)
+    env.assertEqual(ret, b'OK')
+
+    # The first three model runs are independent of each other, so they are executed by
+    # different workers, while the last one depends on two of them.
+    ret = con.execute_command('AI.DAGEXECUTE', 'ROUTING', '{1}',
+                              '|>', 'AI.TENSORSET', 'a', 'FLOAT', 2, 'VALUES', 2, 3,
+                              '|>', 'AI.TENSORSET', 'b', 'FLOAT', 2, 'VALUES', 2, 3,
+                              '|>', 'AI.MODELEXECUTE', 'm{1}', 'INPUTS', 2, 'a', 'b', 'OUTPUTS', 1, 'c1',
+                              '|>', 'AI.MODELEXECUTE', 'm{1}', 'INPUTS', 2, 'a', 'a', 'OUTPUTS', 1, 'c2',
+                              '|>', 'AI.MODELEXECUTE', 'm{1}', 'INPUTS', 2, 'b', 'b', 'OUTPUTS', 1, 'c3',
+                              '|>', 'AI.MODELEXECUTE', 'm{1}', 'INPUTS', 2, 'c1', 'c2', 'OUTPUTS', 1, 'd',
+                              '|>', 'AI.TENSORGET', 'c3', 'VALUES',
+                              '|>', 'AI.TENSORGET', 'd', 'VALUES')
+    env.assertEqual(ret, [b'OK', b'OK', b'OK', b'OK', b'OK', b'OK', [b'4', b'9'], [b'16', b'81']])
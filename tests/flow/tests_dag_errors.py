@@ -289,3 +289,33 @@ def test_dag_error_before_tensorget_op(env):
         expected_error_msg = 'required broadcastable shapes' \
                              ' 	 [[{{node mul}}]]'
     env.assertContains(expected_error_msg, str(ret[2]))
+
+
+def test_dag_error_in_op_with_waiting_dependent(env):
+    if not TEST_TF:
+        return
+
+    con = get_connection(env, '{1}')
+    tf_model = load_file_content('graph.pb')
+    ret = con.execute_command('AI.MODELSTORE', 'tf_model{1}', 'TF', DEVICE,
+                              'INPUTS', 2, 'a', 'b',
+                              'OUTPUTS', 1, 'mul',
+                              'BLOB', tf_model)
+    env.assertEqual(b'OK', ret)
+
+    # The first two MODELEXECUTE ops are independent, so they are executed by different copies of the DAG.
+    # The last MODELEXECUTE op waits for the output of the second one, which fails due to dim mismatch.
+    # Verify that the waiting op is released (and not executed) once the DAG fails.
+    ret = con.execute_command('AI.DAGEXECUTE_RO', 'ROUTING', '{1}',
+                              '|>', 'AI.TENSORSET', 'a', 'FLOAT', 2, 'VALUES', 2, 3,
+                              '|>', 'AI.TENSORSET', 'b', 'FLOAT', 2, 2, 3,
+                              '|>', 'AI.MODELEXECUTE', 'tf_model{1}', 'INPUTS', 2, 'a', 'a', 'OUTPUTS', 1, 'tC',
+                              '|>', 'AI.MODELEXECUTE', 'tf_model{1}', 'INPUTS', 2, 'a', 'b', 'OUTPUTS', 1, 'tD',
+                              '|>', 'AI.MODELEXECUTE', 'tf_model{1}', 'INPUTS', 2, 'tC', 'tD', 'OUTPUTS', 1, 'tE',
+                              '|>', 'AI.TENSORGET', 'tE', 'VALUES')
+
+    env.assertEqual(ret[0], b'OK')
+    env.assertEqual(ret[1], b'OK')
+    env.assertEqual(type(ret[3]), redis.exceptions.ResponseError)
+    env.assertEqual(ret[4], b'NA')
+    env.assertEqual(ret[5], b'NA')
@@ -95,6 +95,7 @@ def test_pytorch_modelrun_autobatch(env):
     con.execute_command('AI.TENSORSET', 'e{1}', 'FLOAT', 2, 2, 'VALUES', 2, 3, 2, 3)
 
     ensureSlaveSynced(con, env)
+    batches_before = float(get_info_section(con, 'queues')['ai_queue_CPU_batches'])
 
     def run():
         con = get_connection(env, '{1}')
@@ -115,6 +116,133 @@ def test_pytorch_modelrun_autobatch(env):
     values = con.execute_command('AI.TENSORGET', 'f{1}', 'VALUES')
     env.assertEqual(values, [b'4', b'6', b'4', b'6'])
 
+    # Both requests were run in a single batch.
+    queues = get_info_section(con, 'queues')
+    env.assertEqual(float(queues['ai_queue_CPU_batches']), batches_before + 1)
+    env.assertGreater(float(queues['ai_queue_CPU_avg_batch_fill']), 0)
+    env.assertEqual(float(queues['ai_queue_CPU_depth']), 0)
+
+
+def test_pytorch_modelrun_autobatch_reuse_batch(env):
+    if not TEST_PT:
+        return
+
+    con = get_connection(env, '{1}')
+
+    model_pb = load_file_content('pt-minimal.pt')
+
+    ret = con.execute_command('AI.MODELSTORE', 'm{1}', 'TORCH', 'CPU',
+                              'BATCHSIZE', 4, 'MINBATCHSIZE', 2, 'BLOB', model_pb)
+    env.assertEqual(ret, b'OK')
+
+    # Run two batches in a row, where the second one reuses the batch tensors of the first one.
+    # Outputs of the first batch must not be affected by the second batch.
+    def run_batch(values, outputs):
+        con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 2, 2, 'VALUES', *values)
+        con.execute_command('AI.TENSORSET', 'b{1}', 'FLOAT', 2, 2, 'VALUES', *values)
+
+        def run():
+            con = get_connection(env, '{1}')
+            con.execute_command('AI.MODELEXECUTE', 'm{1}', 'INPUTS', 2, 'a{1}', 'b{1}',
+                                'OUTPUTS', 1, outputs[1])
+
+        t = threading.Thread(target=run)
+        t.start()
+        con.execute_command('AI.MODELEXECUTE', 'm{1}', 'INPUTS', 2, 'a{1}', 'b{1}',
+                            'OUTPUTS', 1, outputs[0])
+        t.join()
+
+    run_batch([2, 3, 2, 3], ['c{1}', 'd{1}'])
+    run_batch([1, 1, 1, 1], ['e{1}', 'f{1}'])
+    ensureSlaveSynced(con, env)
+
+    for output in ['c{1}', 'd{1}']:
+        values = con.execute_command('AI.TENSORGET', output, 'VALUES')
+        env.assertEqual(values, [b'4', b'6', b'4', b'6'])
+    for output in ['e{1}', 'f{1}']:
+        values = con.execute_command('AI.TENSORGET', output, 'VALUES')
+        env.assertEqual(values, [b'2', b'2', b'2', b'2'])
+
+
+def test_pytorch_modelrun_autobatch_latency_target(env):
+    if not TEST_PT:
+        return
+
+    con = get_connection(env, '{1}')
+
+    model_pb = load_file_content('pt-minimal.pt')
+
+    ret = con.execute_command('AI.MODELSTORE', 'm{1}', 'TORCH', 'CPU',
+                              'BATCHSIZE', 4, 'LATENCYTARGET', 100, 'BLOB', model_pb)
+    env.assertEqual(ret, b'OK')
+    meta = con.execute_command('AI.MODELGET', 'm{1}', 'META')
+    env.assertEqual(meta[-2:], [b'latencytarget', 100])
+
+    con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 2, 2, 'VALUES', 2, 3, 2, 3)
+    con.execute_command('AI.TENSORSET', 'b{1}', 'FLOAT', 2, 2, 'VALUES', 2, 3, 2, 3)
+    ensureSlaveSynced(con, env)
+
+    # Concurrent requests are batched adaptively, and each one of them must complete
+    # with its own results (whether it was batched or not).
+    def run(i):
+        con = get_connection(env, '{1}')
+        con.execute_command('AI.MODELEXECUTE', 'm{1}', 'INPUTS', 2, 'a{1}', 'b{1}',
+                            'OUTPUTS', 1, 'c{}{{1}}'.format(i))
+
+    for _ in range(5):
+        threads = [threading.Thread(target=run, args=(i,)) for i in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+    ensureSlaveSynced(con, env)
+    for i in range(4):
+        values = con.execute_command('AI.TENSORGET', 'c{}{{1}}'.format(i), 'VALUES')
+        env.assertEqual(values, [b'4', b'6', b'4', b'6'])
+
+
+def test_pytorch_modelrun_autobatch_latency_target_warmup(env):
+    if not TEST_PT:
+        return
+
+    con = get_connection(env, '{1}')
+
+    model_pb = load_file_content('pt-minimal.pt')
+
+    ret = con.execute_command('AI.MODELSTORE', 'm{1}', 'TORCH', 'CPU',
+                              'BATCHSIZE', 4, 'LATENCYTARGET', 5, 'BLOB', model_pb)
+    env.assertEqual(ret, b'OK')
+
+    # The first run is over a full batch, and it takes much longer than the latency
+    # target (as a run might while the backend warms up), so the batch size drops.
+    big = np.ones((4, 4000000), dtype=np.float32)
+    con.execute_command('AI.TENSORSET', 'big{1}', 'FLOAT', 4, 4000000, 'BLOB', big.tobytes())
+    con.execute_command('AI.MODELEXECUTE', 'm{1}', 'INPUTS', 2, 'big{1}', 'big{1}',
+                        'OUTPUTS', 1, 'big_out{1}')
+    con.execute_command('DEL', 'big{1}', 'big_out{1}')
+
+    # The later runs are fast, so the estimate of the full batch decays, and requests
+    # that arrive together are batched again.
+    con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 2, 2, 'VALUES', 2, 3, 2, 3)
+    for _ in range(100):
+        con.execute_command('AI.MODELEXECUTE', 'm{1}', 'INPUTS', 2, 'a{1}', 'a{1}',
+                            'OUTPUTS', 1, 'c{1}')
+
+    batches_before = float(get_info_section(con, 'queues')['ai_queue_CPU_batches'])
+    pipe = con.pipeline(transaction=False)
+    for i in range(20):
+        pipe.execute_command('AI.MODELEXECUTE', 'm{1}', 'INPUTS', 2, 'a{1}', 'a{1}',
+                             'OUTPUTS', 1, 'c{}{{1}}'.format(i))
+    env.assertEqual(pipe.execute(), [b'OK'] * 20)
+    batches = float(get_info_section(con, 'queues')['ai_queue_CPU_batches'])
+    env.assertLess(batches - batches_before, 20)
+
+    ensureSlaveSynced(con, env)
+    for i in range(20):
+        values = con.execute_command('AI.TENSORGET', 'c{}{{1}}'.format(i), 'VALUES')
+        env.assertEqual(values, [b'4', b'6', b'4', b'6'])
+
 
 def test_pytorch_modelrun_autobatch_badbatch(env):
     if not TEST_PT:
@@ -193,6 +321,18 @@ def test_pytorch_modelinfo(env):
 
         previous_duration = info_dict_0['duration']
 
+    # Latency percentiles are monotonic, and the end-to-end latency of a request covers
+    # both its queue wait and its execution.
+    for latency in ['duration', 'queue_wait', 'end_to_end']:
+        percentiles = [info_dict_0[latency + '_' + p] for p in ['p50', 'p90', 'p99', 'p999']]
+        env.assertEqual(percentiles, sorted(percentiles))
+    env.assertTrue(info_dict_0['duration_p50'] > 0)
+    env.assertGreaterEqual(info_dict_0['end_to_end_p999'], info_dict_0['duration_p999'])
+    env.assertGreaterEqual(info_dict_0['end_to_end_p999'], info_dict_0['queue_wait_p999'])
+
+    latency_info = get_info_section(con, 'latency')
+    env.assertTrue('ai_' + model_key in latency_info.keys())
+
     res = con.execute_command('AI.INFO', model_key, 'RESETSTAT')
     env.assertEqual(res, b'OK')
     info = con.execute_command('AI.INFO', model_key)
@@ -201,6 +341,8 @@ def test_pytorch_modelinfo(env):
     env.assertEqual(info_dict_0['samples'], 0)
     env.assertEqual(info_dict_0['calls'], 0)
     env.assertEqual(info_dict_0['errors'], 0)
+    env.assertEqual(info_dict_0['duration_p99'], 0)
+    env.assertEqual(info_dict_0['end_to_end_p99'], 0)
 
 
 def test_pytorch_scriptget(env):
@@ -313,6 +455,111 @@ def test_pytorch_scriptexecute(env):
         env.assertEqual(values2, values)
 
 
+def test_pytorch_scriptexecute_autobatch(env):
+    if not TEST_PT:
+        env.debugPrint("skipping {} since TEST_PT=0".format(sys._getframe().f_code.co_name), force=True)
+        return
+
+    con = get_connection(env, '{1}')
+
+    script = load_file_content('script.txt')
+
+    check_error_message(env, con, "BATCHSIZE specified for an unknown entry point",
+                        'AI.SCRIPTSTORE', 'myscript{1}', DEVICE, 'ENTRY_POINTS', 1, 'bar',
+                        'BATCHSIZE', 'bar_variadic', 4, 'SOURCE', script)
+    check_error_message(env, con, "MINBATCHTIMEOUT specified without MINBATCHSIZE",
+                        'AI.SCRIPTSTORE', 'myscript{1}', DEVICE, 'ENTRY_POINTS', 1, 'bar',
+                        'BATCHSIZE', 'bar', 4, 'MINBATCHTIMEOUT', 1000, 'SOURCE', script)
+
+    ret = con.execute_command('AI.SCRIPTSTORE', 'myscript{1}', 'CPU', 'ENTRY_POINTS', 2, 'bar', 'bar_variadic',
+                              'BATCHSIZE', 'bar', 4, 'MINBATCHSIZE', 2, 'SOURCE', script)
+    env.assertEqual(ret, b'OK')
+
+    _, _, _, _, _, entry_points, _, batching = con.execute_command('AI.SCRIPTGET', 'myscript{1}', 'META')
+    env.assertEqual(entry_points, [b'bar', b'bar_variadic'])
+    env.assertEqual(batching, [[b'bar', 4, 2, 0]])
+
+    con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 2, 2, 'VALUES', 2, 3, 2, 3)
+    con.execute_command('AI.TENSORSET', 'b{1}', 'FLOAT', 2, 2, 'VALUES', 2, 3, 2, 3)
+    con.execute_command('AI.TENSORSET', 'd{1}', 'FLOAT', 1, 2, 'VALUES', 1, 1)
+    con.execute_command('AI.TENSORSET', 'e{1}', 'FLOAT', 1, 2, 'VALUES', 5, 6)
+
+    ensureSlaveSynced(con, env)
+    batches_before = float(get_info_section(con, 'queues')['ai_queue_CPU_batches'])
+
+    def run():
+        con = get_connection(env, '{1}')
+        con.execute_command('AI.SCRIPTEXECUTE', 'myscript{1}', 'bar', 'KEYS', 1, '{1}',
+                            'INPUTS', 2, 'd{1}', 'e{1}', 'OUTPUTS', 1, 'f{1}')
+        ensureSlaveSynced(con, env)
+
+    t = threading.Thread(target=run)
+    t.start()
+
+    con.execute_command('AI.SCRIPTEXECUTE', 'myscript{1}', 'bar', 'KEYS', 1, '{1}',
+                        'INPUTS', 2, 'a{1}', 'b{1}', 'OUTPUTS', 1, 'c{1}')
+    t.join()
+
+    ensureSlaveSynced(con, env)
+
+    values = con.execute_command('AI.TENSORGET', 'c{1}', 'VALUES')
+    env.assertEqual(values, [b'4', b'6', b'4', b'6'])
+    values = con.execute_command('AI.TENSORGET', 'f{1}', 'VALUES')
+    env.assertEqual(values, [b'6', b'7'])
+
+    # Both calls were run in a single batch.
+    queues = get_info_section(con, 'queues')
+    env.assertEqual(float(queues['ai_queue_CPU_batches']), batches_before + 1)
+
+    # The batching options survive a reload.
+    con.execute_command('DEBUG', 'RELOAD')
+    _, _, _, _, _, _, _, batching = con.execute_command('AI.SCRIPTGET', 'myscript{1}', 'META')
+    env.assertEqual(batching, [[b'bar', 4, 2, 0]])
+
+
+def test_pytorch_scriptexecute_autobatch_mixed_types(env):
+    if not TEST_PT:
+        env.debugPrint("skipping {} since TEST_PT=0".format(sys._getframe().f_code.co_name), force=True)
+        return
+
+    con = get_connection(env, '{1}')
+
+    script = load_file_content('script.txt')
+    ret = con.execute_command('AI.SCRIPTSTORE', 'myscript{1}', 'CPU', 'ENTRY_POINTS', 1, 'bar',
+                              'BATCHSIZE', 'bar', 4, 'MINBATCHSIZE', 2, 'MINBATCHTIMEOUT', 1000,
+                              'SOURCE', script)
+    env.assertEqual(ret, b'OK')
+
+    con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 1, 2, 'VALUES', 1.5, 2.5)
+    con.execute_command('AI.TENSORSET', 'b{1}', 'FLOAT', 1, 2, 'VALUES', 2, 3)
+    con.execute_command('AI.TENSORSET', 'c{1}', 'INT64', 1, 2, 'VALUES', 4, 5)
+    con.execute_command('AI.TENSORSET', 'd{1}', 'INT64', 1, 2, 'VALUES', 6, 7)
+    ensureSlaveSynced(con, env)
+
+    # Calls whose inputs have the same shapes but different types are not batched together.
+    runs = [('a{1}', 'b{1}', 'out_float{1}'), ('c{1}', 'd{1}', 'out_int{1}'),
+            ('b{1}', 'a{1}', 'out_float2{1}'), ('d{1}', 'c{1}', 'out_int2{1}')]
+
+    def run(in1, in2, out):
+        con = get_connection(env, '{1}')
+        con.execute_command('AI.SCRIPTEXECUTE', 'myscript{1}', 'bar', 'KEYS', 1, '{1}',
+                            'INPUTS', 2, in1, in2, 'OUTPUTS', 1, out)
+
+    threads = [threading.Thread(target=run, args=args) for args in runs]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    ensureSlaveSynced(con, env)
+    for out in ['out_float{1}', 'out_float2{1}']:
+        ret = con.execute_command('AI.TENSORGET', out, 'META', 'VALUES')
+        env.assertEqual(ret, [b'dtype', b'FLOAT', b'shape', [1, 2], b'values', [b'3.5', b'5.5']])
+    for out in ['out_int{1}', 'out_int2{1}']:
+        ret = con.execute_command('AI.TENSORGET', out, 'META', 'VALUES')
+        env.assertEqual(ret, [b'dtype', b'INT64', b'shape', [1, 2], b'values', [10, 12]])
+
+
 def test_pytorch_scriptexecute_list_input(env):
     if not TEST_PT:
         env.debugPrint("skipping {} since TEST_PT=0".format(sys._getframe().f_code.co_name), force=True)
@@ -442,6 +689,49 @@ def test_pytorch_scriptinfo(env):
     env.assertEqual(info_dict_0['errors'], 0)
 
 
+def test_pytorch_dag_queue_wait(env):
+    if not TEST_PT:
+        env.debugPrint("skipping {} since TEST_PT=0".format(sys._getframe().f_code.co_name), force=True)
+        return
+
+    con = get_connection(env, '{1}')
+
+    slow_script = r'''
+def slow(tensors: List[Tensor], keys: List[str], args: List[str]):
+    a = tensors[0]
+    for i in range(20000):
+        a = a + 1
+    return a
+'''
+    fast_script = r'''
+def fast(tensors: List[Tensor], keys: List[str], args: List[str]):
+    return tensors[0] * 2
+'''
+    ret = con.execute_command('AI.SCRIPTSTORE', 'slow_script{1}', DEVICE, 'ENTRY_POINTS', 1, 'slow',
+                              'SOURCE', slow_script)
+    env.assertEqual(ret, b'OK')
+    ret = con.execute_command('AI.SCRIPTSTORE', 'fast_script{1}', DEVICE, 'ENTRY_POINTS', 1, 'fast',
+                              'SOURCE', fast_script)
+    env.assertEqual(ret, b'OK')
+    con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 2, 'VALUES', 0, 1)
+
+    for _ in range(5):
+        ret = con.execute_command('AI.DAGEXECUTE', 'LOAD', 1, 'a{1}', '|>',
+                                  'AI.SCRIPTEXECUTE', 'slow_script{1}', 'slow',
+                                  'INPUTS', 1, 'a{1}', 'OUTPUTS', 1, 'tmp', '|>',
+                                  'AI.SCRIPTEXECUTE', 'fast_script{1}', 'fast',
+                                  'INPUTS', 1, 'tmp', 'OUTPUTS', 1, 'out', '|>',
+                                  'AI.TENSORGET', 'out', 'VALUES')
+        env.assertEqual(ret[2], [b'40000', b'40002'])
+
+    # The queue wait of the second op does not include the execution of the first one.
+    slow_info = info_to_dict(con.execute_command('AI.INFO', 'slow_script{1}'))
+    fast_info = info_to_dict(con.execute_command('AI.INFO', 'fast_script{1}'))
+    env.assertEqual(fast_info['calls'], 5)
+    env.assertLess(fast_info['queue_wait_p999'], slow_info['duration_p50'])
+    env.assertGreaterEqual(fast_info['end_to_end_p50'], slow_info['duration_p50'])
+
+
 def test_pytorch_scriptexecute_disconnect(env):
     if not TEST_PT:
         env.debugPrint("skipping {} since TEST_PT=0".format(sys._getframe().f_code.co_name), force=True)
@@ -597,3 +887,40 @@ def test_torch_info(env):
 
     backends_info = get_info_section(con, 'backends_info')
     env.assertTrue('ai_Torch_version' in backends_info)
+
+
+def test_torch_outputs_copies(env):
+    if not TEST_PT:
+        env.debugPrint("skipping {}".format(sys._getframe().f_code.co_name), force=True)
+        return
+    con = get_connection(env, '{1}')
+
+    script = '''
+def add(tensors: List[Tensor], keys: List[str], args: List[str]):
+    return tensors[0] + tensors[1]
+
+def transpose(tensors: List[Tensor], keys: List[str], args: List[str]):
+    return tensors[0].t()
+'''
+    ret = con.execute_command('AI.SCRIPTSTORE', 'copies_script{1}', 'CPU', 'ENTRY_POINTS', 2, 'add', 'transpose',
+                              'SOURCE', script)
+    env.assertEqual(ret, b'OK')
+    con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 2, 2, 'VALUES', 1, 2, 3, 4)
+
+    def outputs_copies():
+        backends_info = get_info_section(con, 'backends_info')
+        return (int(backends_info['ai_Torch_outputs_copied']),
+                int(backends_info['ai_Torch_outputs_copies_saved']))
+
+    # A contiguous output is handed back without copying it.
+    copied, copies_saved = outputs_copies()
+    con.execute_command('AI.SCRIPTEXECUTE', 'copies_script{1}', 'add', 'INPUTS', 2, 'a{1}', 'a{1}',
+                        'OUTPUTS', 1, 'b{1}')
+    env.assertEqual(con.execute_command('AI.TENSORGET', 'b{1}', 'VALUES'), [b'2', b'4', b'6', b'8'])
+    env.assertEqual(outputs_copies(), (copied, copies_saved))
+
+    # A transposed (non contiguous) output on the CPU is materialized with a single copy, as before.
+    con.execute_command('AI.SCRIPTEXECUTE', 'copies_script{1}', 'transpose', 'INPUTS', 1, 'a{1}',
+                        'OUTPUTS', 1, 'c{1}')
+    env.assertEqual(con.execute_command('AI.TENSORGET', 'c{1}', 'VALUES'), [b'1', b'3', b'2', b'4'])
+    env.assertEqual(outputs_copies(), (copied + 1, copies_saved))
@@ -5,6 +5,7 @@
 import numpy as np
 
 from includes import *
+from RLTest import Env
 
 '''
 python -m RLTest --test tests_tflite.py --module path/to/redisai.so
@@ -264,3 +265,92 @@ def test_tflite_info(env):
 
     backends_info = get_info_section(con, 'backends_info')
     env.assertTrue('ai_TensorFlowLite_version' in backends_info)
+
+
+def test_tflite_modelrun_parallel():
+    env = Env(moduleArgs='THREADS_PER_QUEUE 4')
+    if not TEST_TFLITE:
+        env.debugPrint("skipping {} since TEST_TFLITE=0".format(sys._getframe().f_code.co_name), force=True)
+        return
+
+    con = get_connection(env, '{1}')
+    load_time_config = get_info_section(con, 'load_time_configs')
+    env.assertEqual(load_time_config['ai_model_session_pool_size'], '4')
+
+    model_pb = load_file_content('mnist_model_quant.tflite')
+    sample_raw = load_file_content('one.raw')
+    ret = con.execute_command('AI.MODELSTORE', 'm{1}', 'TFLITE', 'CPU', 'BLOB', model_pb)
+    env.assertEqual(ret, b'OK')
+    con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 1, 1, 28, 28, 'BLOB', sample_raw)
+
+    # Every working thread runs the same model concurrently, each with an interpreter of its own.
+    def run_model(con, i):
+        for _ in range(10):
+            con.execute_command('AI.MODELEXECUTE', 'm{1}', 'INPUTS', 1, 'a{1}',
+                                'OUTPUTS', 2, 'b{1}_'+str(i), 'c{1}_'+str(i))
+            values = con.execute_command('AI.TENSORGET', 'b{1}_'+str(i), 'VALUES')
+            env.assertEqual(values[0], 1)
+    run_test_multiproc(env, '{1}', 8, run_model)
+
+    env = Env(moduleArgs='THREADS_PER_QUEUE 4 MODEL_SESSION_POOL_SIZE 2')
+    con = get_connection(env, '{1}')
+    load_time_config = get_info_section(con, 'load_time_configs')
+    env.assertEqual(load_time_config['ai_model_session_pool_size'], '2')
+
+
+def test_tflite_modelrun_threads():
+    env = Env(moduleArgs='INTRA_OP_PARALLELISM 2')
+    if not TEST_TFLITE:
+        env.debugPrint("skipping {} since TEST_TFLITE=0".format(sys._getframe().f_code.co_name), force=True)
+        return
+
+    con = get_connection(env, '{1}')
+    model_pb = load_file_content('mnist_model_quant.tflite')
+    sample_raw = load_file_content('one.raw')
+    con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 1, 1, 28, 28, 'BLOB', sample_raw)
+
+    # The interpreters of the model use INTRA_OP_PARALLELISM threads.
+    ret = con.execute_command('AI.MODELSTORE', 'm{1}', 'TFLITE', 'CPU', 'BLOB', model_pb)
+    env.assertEqual(ret, b'OK')
+    con.execute_command('AI.MODELEXECUTE', 'm{1}', 'INPUTS', 1, 'a{1}', 'OUTPUTS', 2, 'b{1}', 'c{1}')
+    values = con.execute_command('AI.TENSORGET', 'b{1}', 'VALUES')
+    env.assertEqual(values[0], 1)
+
+
+def test_tflite_shape_cache():
+    env = Env(moduleArgs='MODEL_SESSION_POOL_SIZE 2')
+    if not TEST_TFLITE:
+        env.debugPrint("skipping {} since TEST_TFLITE=0".format(sys._getframe().f_code.co_name), force=True)
+        return
+
+    con = get_connection(env, '{1}')
+    model_pb = load_file_content('lite-model_imagenet_mobilenet_v3_small_100_224_classification_5_default_1.tflite')
+    _, _, _, img = load_resnet_test_data()
+    img = img.astype(np.float32) / 255
+    batch = np.stack([img, img])
+
+    ret = con.execute_command('AI.MODELSTORE', 'm{1}', 'TFLITE', 'CPU', 'BLOB', model_pb)
+    env.assertEqual(ret, b'OK')
+    con.execute_command('AI.TENSORSET', 'a{1}', 'FLOAT', 1, img.shape[1], img.shape[0], 3,
+                        'BLOB', img.tobytes())
+    con.execute_command('AI.TENSORSET', 'b{1}', 'FLOAT', 2, img.shape[1], img.shape[0], 3,
+                        'BLOB', batch.tobytes())
+
+    def run(input_key):
+        con.execute_command('AI.MODELEXECUTE', 'm{1}', 'INPUTS', 1, input_key, 'OUTPUTS', 1, 'c{1}')
+
+    def shape_cache_counts():
+        backends_info = get_info_section(con, 'backends_info')
+        return (int(backends_info['ai_TensorFlowLite_shape_cache_hits']),
+                int(backends_info['ai_TensorFlowLite_shape_cache_misses']))
+
+    # Once the model has an interpreter planned for each batch size (the pool holds two
+    # interpreters), alternating between them does not require re-planning.
+    run('a{1}')
+    run('b{1}')
+    hits, misses = shape_cache_counts()
+    for _ in range(2):
+        run('a{1}')
+        run('b{1}')
+    env.assertEqual(shape_cache_counts(), (hits + 4, misses))
+    env.assertEqual(con.execute_command('AI.TENSORGET', 'c{1}', 'META')[-1][0], 2)
@@ -426,6 +426,33 @@ int RAI_llapi_SliceTensor(RedisModuleCtx *ctx, RedisModuleString **argv, int arg
     }
     RedisAI_TensorFree(t1);
     RedisAI_TensorFree(t2);
+
+    // test slicing numeric tensors (including slicing a slice), and that setting the data of a
+    // slice does not affect the sliced tensor.
+    long long num_dims[] = {4, 2};
+    RAI_Tensor *num_tensor = RedisAI_TensorCreate("INT32", num_dims, n_dims);
+    int32_t num_data[] = {0, 1, 2, 3, 4, 5, 6, 7};
+    RedisAI_TensorSetData(num_tensor, (const char *)num_data, sizeof(num_data));
+    RAI_Tensor *t3 = RedisAI_TensorCreateBySlicingTensor(num_tensor, 1, 3);
+    RAI_Tensor *t4 = RedisAI_TensorCreateBySlicingTensor(t3, 1, 1);
+    RedisAI_TensorFree(num_tensor);
+
+    if (RedisAI_TensorDim(t3, 0) != 3 || RedisAI_TensorByteSize(t3) != 6 * sizeof(int32_t) ||
+        memcmp(num_data + 2, RedisAI_TensorData(t3), 6 * sizeof(int32_t)) != 0 ||
+        RedisAI_TensorDim(t4, 0) != 1 ||
+        memcmp(num_data + 4, RedisAI_TensorData(t4), 2 * sizeof(int32_t)) != 0) {
+        return RedisModule_ReplyWithSimpleString(ctx, "numeric tensor slicing test failed");
+    }
+
+    int32_t new_data[] = {8, 9};
+    RedisAI_TensorSetData(t4, (const char *)new_data, sizeof(new_data));
+    if (memcmp(new_data, RedisAI_TensorData(t4), sizeof(new_data)) != 0 ||
+        memcmp(num_data + 4, RedisAI_TensorData(t3) + 2 * sizeof(int32_t),
+               2 * sizeof(int32_t)) != 0) {
+        return RedisModule_ReplyWithSimpleString(ctx, "numeric tensor slicing test failed");
+    }
+    RedisAI_TensorFree(t3);
+    RedisAI_TensorFree(t4);
     return RedisModule_ReplyWithSimpleString(ctx, "slice tensor test success");
 }
 